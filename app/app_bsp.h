@@ -21,23 +21,142 @@
     #include "stm32g0xx_hal_wwdg.h"
     #include "stm32g0xx_hal_spi.h"
     #include "stm32g0xx_hal_spi_ex.h"
-    #include "hil_queue.h"
-    #include "scheduler.h"
-    #include <stdint.h>
-    #include <string.h>
 
 /**
- * @defgroup Tasks, timers & tick time (ms) for the functioning of the scheduler.
+ * @defgroup Tasks, timers & tick time (ms) for the functioning of the scheduler, every scheduler
+ * setting can be overridden from the compiler command line (the host simulator does).
  @{*/
+#ifndef TASKS_N
 #define TASKS_N     5       /*!< Specifies the number of tasks.*/
+#endif
+#ifndef TIMERS_N
 #define TIMERS_N    1       /*!< Specifies the number of timers.*/
+#endif
+#ifndef TICK_VAL
 #define TICK_VAL    10      /*!< Value of the tick.*/
+#endif
+#ifndef SCHEDULER_WHEEL_SLOTS
+#define SCHEDULER_WHEEL_SLOTS   32  /*!< Slots of the software timers wheel, must be a power of two.*/
+#endif
+/**@} */
+
+/**
+ * @defgroup Scheduler build options, set to 1 to enable or 0 to disable. The measurements are off in
+ * the release build, make DEBUG=1 turns them on.
+ @{*/
+#ifndef SCHEDULER_LOW_POWER
+#define SCHEDULER_LOW_POWER     1   /*!< Sleep the core (WFI) until the next task or timer deadline.*/
+#endif
+#ifndef SCHEDULER_PROFILER
+#define SCHEDULER_PROFILER      0   /*!< Measure the execution time of every task with TIM6.*/
+#endif
+#ifndef SCHEDULER_LOAD_METER
+#define SCHEDULER_LOAD_METER    0   /*!< Measure the time of every tick spent running tasks with TIM6.*/
+#endif
+#ifndef SCHEDULER_STACK_MONITOR
+#define SCHEDULER_STACK_MONITOR 0   /*!< Paint the stack of linker.ld and measure its deepest use after every task.*/
+#endif
+#ifndef SCHEDULER_STATIC_TASKS
+#define SCHEDULER_STATIC_TASKS  1   /*!< Take the tasks from a const table in flash instead of registering them.*/
+#endif
+#ifndef SCHEDULER_AUTO_PHASE
+#define SCHEDULER_AUTO_PHASE    1   /*!< Give an offset to the tasks without one to stagger the tasks with related periods.*/
+#endif
+/**@} */
+
+/**
+ * @defgroup Scheduler cyclic executive, the due tasks of every tick of the hyperperiod are taken from a
+ * table generated at build time from the static task list instead of counting the time of every task.
+ @{*/
+#ifndef SCHEDULER_CYCLIC
+#define SCHEDULER_CYCLIC        0   /*!< Dispatch from the cyclic executive table, needs SCHEDULER_STATIC_TASKS.*/
+#endif
+#ifndef SCHEDULER_HYPERPERIOD
+#define SCHEDULER_HYPERPERIOD   1200    /*!< Least common multiple of the task periods in ms.*/
+#endif
+/**@} */
+
+/**
+ * @defgroup Scheduler time budget of every tick in us, 0 to run all the due tasks regardless of the time.
+ @{*/
+#ifndef SCHEDULER_TICK_BUDGET
+#define SCHEDULER_TICK_BUDGET   8000    /*!< The due tasks that don't fit in the budget run on the next tick.*/
+#endif
+/**@} */
+
+/**
+ * @defgroup Scheduler deadline misses, a task misses its deadline when the time between two executions
+ * deviates from its period more than the tolerance.
+ @{*/
+#ifndef SCHEDULER_JITTER_BINS
+#define SCHEDULER_JITTER_BINS       8   /*!< Bins of the jitter histogram of every task.*/
+#endif
+#ifndef SCHEDULER_MISS_TOLERANCE
+#define SCHEDULER_MISS_TOLERANCE    10  /*!< Deviation allowed in percent of the period.*/
+#endif
+#ifndef SCHEDULER_MISS_ACTION
+#define SCHEDULER_MISS_ACTION       SCHEDULER_MISS_COUNT    /*!< SCHEDULER_MISS_COUNT, SCHEDULER_MISS_LOG or SCHEDULER_MISS_ESCALATE.*/
+#endif
+#ifndef SCHEDULER_MISS_LIMIT
+#define SCHEDULER_MISS_LIMIT        3   /*!< Misses in a row of a task that go to the safe state with SCHEDULER_MISS_ESCALATE.*/
+#endif
 /**@} */
 
+/**
+ * @defgroup Scheduler deferred callbacks, queued by the interrupts to run in the scheduler loop.
+ @{*/
+#ifndef SCHEDULER_DEFER_N
+#define SCHEDULER_DEFER_N           4   /*!< Callbacks waiting to run at the same time, 0 to leave them out.*/
+#endif
+/**@} */
+
+/**
+ * @defgroup CAN link, classic frames of 8 bytes or CAN FD frames of up to 64 bytes with a faster data phase.
+ @{*/
+#ifndef SERIAL_CAN_FD
+#define SERIAL_CAN_FD       0       /*!< Use CAN FD with bit rate switching instead of classic CAN.*/
+#endif
+#if SERIAL_CAN_FD == 1
+#define CAN_FRAME_SIZE      64u     /*!< Largest frame data field in bytes.*/
+#else
+#define CAN_FRAME_SIZE      8u      /*!< Largest frame data field in bytes.*/
+#endif
+/**@} */
+
+/**
+ * @defgroup ISO-TP transport of the CAN link, buffers in bytes and times in ms.
+ @{*/
+#ifndef CANTP_RX_SIZE
+#define CANTP_RX_SIZE       128     /*!< Longest message received, up to 4095.*/
+#endif
+#ifndef CANTP_TX_SIZE
+#define CANTP_TX_SIZE       128     /*!< Longest message sent, up to 4095.*/
+#endif
+#ifndef CANTP_BLOCK_SIZE
+#define CANTP_BLOCK_SIZE    8u      /*!< Consecutive frames between flow controls, below the frames of the CAN queue.*/
+#endif
+#ifndef CANTP_STMIN
+#define CANTP_STMIN         0u      /*!< Separation time asked between consecutive frames.*/
+#endif
+#ifndef CANTP_TIMEOUT
+#define CANTP_TIMEOUT       1000u   /*!< Time without frames of the other end that drops a transfer.*/
+#endif
+/**@} */
+
+    #include "hil_queue.h"
+    #include "hil_pool.h"
+    #include "scheduler.h"
+    #include <stdint.h>
+    #include <string.h>
+
 extern WWDG_HandleTypeDef WDGHandler;
 
 extern FDCAN_HandleTypeDef  CANHandler;
 
+extern Scheduler_HandleTypeDef Sche;
+
+extern uint8_t SerialTaskID;
+
 /**
  * @brief Macro to garantee that the input parameters or output results of the functions have 
  * the expected values.
@@ -71,7 +190,11 @@ typedef enum _App_ErrorsCode {
     FLASH_FUNC_ERROR,           /*!< FLASH ERROR          17*/
     SCHEDULER_PAR_ERROR,        /*!< SCHEDULER ERROR      18*/
     SCHEDULER_TASK_ERROR,       /*!< SCHEDULER TASK ERROR 19*/
-    TIMER_PAR_ERROR             /*!< TIMER ERROR          20*/
+    TIMER_PAR_ERROR,            /*!< TIMER ERROR          20*/
+    SCHEDULER_STACK_ERROR,      /*!< STACK OVERFLOW       21*/
+    QUEUE_PAR_ERROR,            /*!< QUEUE ERROR          22*/
+    POOL_PAR_ERROR,             /*!< POOL ERROR           23*/
+    CANTP_PAR_ERROR             /*!< CANTP ERROR          24*/
 } 
 /*cppcheck-suppress misra-c2012-2.3 ; Macro required for functional safety.*/
 App_ErrorsCode;
@@ -117,7 +240,41 @@ typedef struct _APP_MsgTypeDef
     APP_TmTypeDef tm;     /*!< time and date in stdlib tm format */
 } APP_MsgTypeDef;
 
-extern APP_MsgTypeDef   DataStorage;
+/**
+  * @brief   Pointer to a message block of the pool, what the queues between tasks carry.
+  */
+typedef APP_MsgTypeDef *APP_MsgRefTypeDef;
+
+/*The clock task takes every pending message once each 50 ms, late by up to one 10 ms run of the serial
+  task, so a block is held at most 60 ms. Each message takes a request and a reply frame of 8 data bytes:
+  - Classic at 100 kbit/s: 111 bits (stuffing left out) = 1.11 ms per frame, 2.22 ms per message,
+    60 ms / 2.22 ms = 27 messages + 1 = 28 blocks.
+  - FD with 100 kbit/s arbitration and 1 Mbit/s data: 30 bits + 91 bits = 0.39 ms per frame, 0.78 ms per
+    message, 60 ms / 0.78 ms = 77 messages + 1 = 78 blocks.*/
+#ifndef APP_MSG_BLOCKS
+#if SERIAL_CAN_FD == 1
+#define APP_MSG_BLOCKS  78u     /*!< Message blocks of the pool, the messages in flight at the same time.*/
+#else
+#define APP_MSG_BLOCKS  28u     /*!< Message blocks of the pool, the messages in flight at the same time.*/
+#endif
+#endif
+
+/**
+  * @brief   Pool of the message blocks, the serial task takes them and the clock task gives them back.
+  */
+extern POOL_HandleTypeDef MsgPool;
+
+/**
+  * @brief   Queue of the messages from the serial task to the clock task, one slot per block of the pool.
+  */
+HIL_QUEUE_TYPED( Clock, APP_MsgRefTypeDef, APP_MSG_BLOCKS );
+extern QUEUE_Clock_TypeDef ClockQueue;
+
+/**
+  * @brief   Mailbox with the latest time and date from the clock task to the display task.
+  */
+HIL_QUEUE_TYPED( Display, APP_MsgTypeDef, 1u );
+extern QUEUE_Display_TypeDef DisplayQueue;
 extern APP_Messages     MessageType;
 
 /**
@@ -130,7 +287,8 @@ extern APP_MsgTypeDef ClockMsg;
   */
 typedef struct _NEW_MsgTypeDef 
 {
-  uint8_t data[8]; /*!< Array where the received messages will be saved.*/
+  uint8_t data[CAN_FRAME_SIZE]; /*!< Array where the received messages will be saved.*/
+  uint8_t length;               /*!< Bytes of the data field received.*/
 } NEW_MsgTypeDef;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,458 @@
+/**
+ * @file    app_cantp.c
+ * @brief   **File with the ISO-TP (ISO 15765-2) transport of the CAN link.**
+ *
+ * The first nibble of every frame is the protocol control information: single frame, first frame,
+ * consecutive frame or flow control. A received message is reassembled from the frames given to
+ * CanTp_Rx, sending a flow control after the first frame and after every block. A message given to
+ * CanTp_Send is split in frames that are sent as the flow control of the receiver allows, from
+ * CanTp_Rx when the flow control arrives and from CanTp_Task, which also drops the transfers that
+ * time out. The unused bytes of the frames are sent as zero. A message that finds the Tx Fifo full is
+ * not sent and counted in TxDrops, a flow control is kept and sent again from CanTp_Task.
+ *
+ * With SERIAL_CAN_FD the frames carry up to 64 bytes: a single frame of more than 7 bytes has a zero
+ * size nibble and the size in the second byte, the first frame and the consecutive frames fill the
+ * whole frame, and the last frame is cut to the shortest CAN FD length that holds it. The length of
+ * the first frame received sets the length of its consecutive frames.
+ */
+
+#include "app_cantp.h"
+
+/**
+ * @defgroup <Frame types, first nibble of the frame.>
+ @{ */
+#define CANTP_SF            0x00u   /*!< Single frame, the nibble after it is the size.*/
+#define CANTP_FF            0x10u   /*!< First frame, the next 12 bits are the size.*/
+#define CANTP_CF            0x20u   /*!< Consecutive frame, the nibble after it is the sequence number.*/
+#define CANTP_FC            0x30u   /*!< Flow control, the nibble after it is the flow status.*/
+/**
+ @} */
+
+/**
+ * @defgroup <Flow status of the flow control frames.>
+ @{ */
+#define CANTP_FS_CTS        0x00u   /*!< Continue to send.*/
+#define CANTP_FS_WAIT       0x01u   /*!< Wait for another flow control.*/
+#define CANTP_FS_OVFLW      0x02u   /*!< The message does not fit in the receiver.*/
+#define CANTP_FS_NONE       0xFFu   /*!< No flow control waiting to be sent.*/
+/**
+ @} */
+
+/**
+ * @brief   Bytes of the data field of every DLC.
+ */
+static const uint8_t CanTp_DlcBytes[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+static uint8_t CanTp_Frame( CANTP_HandleTypeDef *hcantp, uint8_t *frame, uint8_t length );
+static void CanTp_FlowControl( CANTP_HandleTypeDef *hcantp, uint8_t status );
+static void CanTp_FlowControlRx( CANTP_HandleTypeDef *hcantp, uint8_t *frame );
+static void CanTp_Consecutive( CANTP_HandleTypeDef *hcantp );
+static uint8_t CanTp_Stmin( uint8_t stmin );
+
+/**
+ * @brief   **Function that clears the state of the transport.**
+ *
+ * The fields Fdcan and TxHeader must be set before, the data length of the header is set by the
+ * transport on every frame it sends.
+ *
+ * @param   <*hcantp[in]> Transport handler.
+ */
+
+void CanTp_Init( CANTP_HandleTypeDef *hcantp ) {
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( ( hcantp->Fdcan != NULL ) && ( hcantp->TxHeader != NULL ), CANTP_PAR_ERROR );
+
+    hcantp->RxState   = CANTP_IDLE;
+    hcantp->TxState   = CANTP_IDLE;
+    hcantp->FcPending = CANTP_FS_NONE;
+    hcantp->TxDrops   = 0;
+}
+
+/**
+ * @brief   **Function that processes a received frame.**
+ *
+ * A single frame is not copied, data points to its payload inside the frame. The frames of a longer
+ * message are copied to the reassembly buffer and data points to it once the last one arrives. A
+ * frame out of sequence drops the message, a single frame or a first frame during a reception
+ * starts over with the new message.
+ *
+ * @param   <*hcantp[in]> Transport handler.
+ * @param   <*frame[in]> The data field of the frame.
+ * @param   <length[in]> Bytes of the data field.
+ * @param   <**data[out]> Pointer to the message received.
+ * @param   <*size[out]> Size of the message received.
+ *
+ * @retval  1 if a message was completed, otherwise a 0.
+ */
+
+uint8_t CanTp_Rx( CANTP_HandleTypeDef *hcantp, uint8_t *frame, uint8_t length, uint8_t **data, uint16_t *size ) {
+    uint8_t Flag = 0;
+    uint16_t Length;
+
+    switch( frame[0] & 0xF0u ) {
+        case CANTP_SF:
+            Length = frame[0] & 0x0Fu;
+            hcantp->RxState = CANTP_IDLE;
+
+            if( ( Length >= 1u ) && ( Length <= 7u ) && ( Length < length ) ) {
+                *( data ) = &frame[1];
+                *( size ) = Length;
+                Flag = 1;
+            }
+            else if( ( Length == 0u ) && ( length > 8u ) && ( frame[1] >= 1u ) && ( frame[1] <= ( length - 2u ) ) ) {
+                *( data ) = &frame[2];
+                *( size ) = frame[1];
+                Flag = 1;
+            }
+            else {
+                /*Wrong size, the frame is dropped*/
+            }
+        break;
+
+        case CANTP_FF:
+            Length = ( uint16_t ) ( ( uint16_t ) ( frame[0] & 0x0Fu ) << 8 ) | frame[1];
+            hcantp->RxState = CANTP_IDLE;
+
+            if( Length > ( uint16_t ) CANTP_RX_SIZE ) {
+                CanTp_FlowControl( hcantp, CANTP_FS_OVFLW );
+            }
+            else if( ( length >= 8u ) && ( Length > 7u ) && ( Length > ( length - 2u ) ) ) {
+                ( void ) memcpy( hcantp->RxBuffer, &frame[2], length - 2u );
+                hcantp->RxSize  = Length;
+                hcantp->RxCount = length - 2u;
+                hcantp->RxDl    = length;
+                hcantp->RxSn    = 1u;
+                hcantp->RxBlock = CANTP_BLOCK_SIZE;
+                hcantp->RxState = CANTP_RX_CF;
+                hcantp->RxTick  = HAL_GetTick();
+                CanTp_FlowControl( hcantp, CANTP_FS_CTS );
+            }
+            else {
+                /*A first frame must carry a message that does not fit in a single frame*/
+            }
+        break;
+
+        case CANTP_CF:
+            if( hcantp->RxState == CANTP_RX_CF ) {
+                Length = hcantp->RxSize - hcantp->RxCount;
+                Length = ( Length > ( hcantp->RxDl - 1u ) ) ? ( hcantp->RxDl - 1u ) : Length;
+
+                if( ( ( frame[0] & 0x0Fu ) != hcantp->RxSn ) || ( Length >= length ) ) {
+                    /*Out of sequence or shorter than the data it has to carry, the message is dropped*/
+                    hcantp->RxState = CANTP_IDLE;
+                }
+                else {
+                    ( void ) memcpy( &hcantp->RxBuffer[ hcantp->RxCount ], &frame[1], Length );
+                    hcantp->RxCount += Length;
+                    hcantp->RxSn = ( hcantp->RxSn + 1u ) & 0x0Fu;
+                    hcantp->RxTick = HAL_GetTick();
+
+                    if( hcantp->RxCount == hcantp->RxSize ) {
+                        hcantp->RxState = CANTP_IDLE;
+                        *( data ) = hcantp->RxBuffer;
+                        *( size ) = hcantp->RxSize;
+                        Flag = 1;
+                    }
+                    else if( ( CANTP_BLOCK_SIZE != 0u ) && ( --hcantp->RxBlock == 0u ) ) {
+                        hcantp->RxBlock = CANTP_BLOCK_SIZE;
+                        CanTp_FlowControl( hcantp, CANTP_FS_CTS );
+                    }
+                    else {
+                        /*More consecutive frames of the same block*/
+                    }
+                }
+            }
+        break;
+
+        case CANTP_FC:
+            CanTp_FlowControlRx( hcantp, frame );
+        break;
+
+        default:
+        break;
+    }
+
+    return Flag;
+}
+
+/**
+ * @brief   **Function that starts the transmission of a message.**
+ *
+ * A message that fits in a single frame is sent right away. A longer one is copied to the
+ * transmission buffer and its first frame is sent, the rest goes as the receiver allows it.
+ *
+ * @param   <*hcantp[in]> Transport handler.
+ * @param   <*data[in]> Message to send.
+ * @param   <size[in]> Size of the message, up to CANTP_TX_SIZE.
+ *
+ * @retval  1 if the transmission started, 0 if another message is being sent, the size is wrong or
+ *          the Tx Fifo is full.
+ */
+
+uint8_t CanTp_Send( CANTP_HandleTypeDef *hcantp, const uint8_t *data, uint16_t size ) {
+    uint8_t Flag = 0;
+    uint8_t Length;
+    uint8_t Frame[CAN_FRAME_SIZE] = {0};
+
+    if( ( hcantp->TxState == CANTP_IDLE ) && ( size >= 1u ) && ( size <= ( uint16_t ) CANTP_TX_SIZE ) ) {
+        if( size <= 7u ) {
+            Frame[0] = CANTP_SF | ( uint8_t ) size;
+            ( void ) memcpy( &Frame[1], data, size );
+            Length = 8u;
+        }
+        else if( size <= ( CAN_FRAME_SIZE - 2u ) ) {
+            Frame[1] = ( uint8_t ) size;
+            ( void ) memcpy( &Frame[2], data, size );
+            Length = ( uint8_t ) size + 2u;
+        }
+        else {
+            Frame[0] = CANTP_FF | ( uint8_t ) ( size >> 8 );
+            Frame[1] = ( uint8_t ) size;
+            ( void ) memcpy( &Frame[2], data, CAN_FRAME_SIZE - 2u );
+            Length = CAN_FRAME_SIZE;
+        }
+
+        Flag = CanTp_Frame( hcantp, Frame, Length );
+
+        if( Flag == 0u ) {
+            hcantp->TxDrops++;
+        }
+        else if( ( Frame[0] & 0xF0u ) == CANTP_FF ) {
+            ( void ) memcpy( hcantp->TxBuffer, data, size );
+            hcantp->TxSize  = size;
+            hcantp->TxCount = CAN_FRAME_SIZE - 2u;
+            hcantp->TxSn    = 1u;
+            hcantp->TxState = CANTP_TX_WAIT_FC;
+            hcantp->TxTick  = HAL_GetTick();
+        }
+        else {
+            /*A single frame ends the transmission*/
+        }
+    }
+
+    return Flag;
+}
+
+/**
+ * @brief   **Function that sends the pending consecutive frames and checks the timeouts.**
+ *
+ * It has to be called periodically, a transfer without frames or flow control from the other end
+ * for CANTP_TIMEOUT ms is dropped. A flow control that found the Tx Fifo full is sent again first.
+ *
+ * @param   <*hcantp[in]> Transport handler.
+ */
+
+void CanTp_Task( CANTP_HandleTypeDef *hcantp ) {
+    uint32_t Tick = HAL_GetTick();
+
+    if( ( hcantp->RxState == CANTP_RX_CF ) && ( ( Tick - hcantp->RxTick ) > ( uint32_t ) CANTP_TIMEOUT ) ) {
+        hcantp->RxState   = CANTP_IDLE;
+        hcantp->FcPending = CANTP_FS_NONE;
+    }
+
+    if( hcantp->FcPending != CANTP_FS_NONE ) {
+        CanTp_FlowControl( hcantp, hcantp->FcPending );
+    }
+
+    if( ( hcantp->TxState == CANTP_TX_WAIT_FC ) && ( ( Tick - hcantp->TxTick ) > ( uint32_t ) CANTP_TIMEOUT ) ) {
+        hcantp->TxState = CANTP_IDLE;
+    }
+
+    CanTp_Consecutive( hcantp );
+}
+
+/**
+ * @brief   **Function that sends a frame if there is room for it in the Tx Fifo.**
+ *
+ * A full Tx Fifo is a burst of frames, not a fault, the frame is left to the caller. With room in
+ * the Tx Fifo the HAL must take the frame.
+ *
+ * @param   <*hcantp[in]> Transport handler.
+ * @param   <*frame[in]> The data field of the frame, padded with zeros up to the next DLC.
+ * @param   <length[in]> Bytes of the data field.
+ *
+ * @retval  1 if the frame was sent, 0 if the Tx Fifo is full.
+ */
+
+static uint8_t CanTp_Frame( CANTP_HandleTypeDef *hcantp, uint8_t *frame, uint8_t length ) {
+    HAL_StatusTypeDef Status;
+    uint8_t Flag = 0;
+
+    if( HAL_FDCAN_GetTxFifoFreeLevel( hcantp->Fdcan ) != 0u ) {
+        hcantp->TxHeader->DataLength = CanTp_Dlc( length );
+
+        /*The function is used and its result is verified.*/
+        Status = HAL_FDCAN_AddMessageToTxFifoQ( hcantp->Fdcan, hcantp->TxHeader, frame );
+        /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+        assert_error( Status == HAL_OK, CAN_RET_ERROR );
+        Flag = 1;
+    }
+
+    return Flag;
+}
+
+/**
+ * @brief   **Function that sends a flow control frame with the block size and STmin of this end.**
+ *
+ * The sender waits for it, so with the Tx Fifo full it is kept and CanTp_Task tries again.
+ *
+ * @param   <*hcantp[in]> Transport handler.
+ * @param   <status[in]> Flow status.
+ */
+
+static void CanTp_FlowControl( CANTP_HandleTypeDef *hcantp, uint8_t status ) {
+    uint8_t Frame[8] = {0};
+
+    Frame[0] = CANTP_FC | status;
+    Frame[1] = CANTP_BLOCK_SIZE;
+    Frame[2] = CANTP_STMIN;
+
+    if( CanTp_Frame( hcantp, Frame, 8u ) == 1u ) {
+        hcantp->FcPending = CANTP_FS_NONE;
+    }
+    else {
+        hcantp->FcPending = status;
+    }
+}
+
+/**
+ * @brief   **Function that processes a flow control frame of the receiver.**
+ *
+ * @param   <*hcantp[in]> Transport handler.
+ * @param   <*frame[in]> The 8 bytes of the frame.
+ */
+
+static void CanTp_FlowControlRx( CANTP_HandleTypeDef *hcantp, uint8_t *frame ) {
+    if( hcantp->TxState == CANTP_TX_WAIT_FC ) {
+        switch( frame[0] & 0x0Fu ) {
+            case CANTP_FS_CTS:
+                hcantp->TxBlockSize = frame[1];
+                hcantp->TxBlock     = frame[1];
+                hcantp->TxStmin     = CanTp_Stmin( frame[2] );
+                hcantp->TxState     = CANTP_TX_CF;
+                /*The first frame of the block does not wait for the separation time*/
+                hcantp->TxTick      = HAL_GetTick() - hcantp->TxStmin - 1u;
+                CanTp_Consecutive( hcantp );
+            break;
+
+            case CANTP_FS_WAIT:
+                hcantp->TxTick = HAL_GetTick();
+            break;
+
+            default:
+                /*Overflow or a wrong flow status, the transfer is dropped*/
+                hcantp->TxState = CANTP_IDLE;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief   **Function that sends the consecutive frames allowed by the flow control.**
+ *
+ * Without separation time the frames are sent until the block ends or one element of the Tx Fifo is
+ * left, kept for the flow control and single frames sent from the task. With separation time one frame
+ * is sent once the time has passed.
+ *
+ * @param   <*hcantp[in]> Transport handler.
+ */
+
+static void CanTp_Consecutive( CANTP_HandleTypeDef *hcantp ) {
+    uint8_t Frame[CAN_FRAME_SIZE];
+    uint16_t Length;
+
+    while( ( hcantp->TxState == CANTP_TX_CF ) &&
+           ( ( hcantp->TxStmin == 0u ) || ( ( HAL_GetTick() - hcantp->TxTick ) > hcantp->TxStmin ) ) &&
+           ( HAL_FDCAN_GetTxFifoFreeLevel( hcantp->Fdcan ) > 1u ) ) {
+        Length = hcantp->TxSize - hcantp->TxCount;
+        Length = ( Length > ( CAN_FRAME_SIZE - 1u ) ) ? ( CAN_FRAME_SIZE - 1u ) : Length;
+
+        ( void ) memset( Frame, 0, sizeof( Frame ) );
+        Frame[0] = CANTP_CF | hcantp->TxSn;
+        ( void ) memcpy( &Frame[1], &hcantp->TxBuffer[ hcantp->TxCount ], Length );
+        /*The free level was checked by the loop, the frame is always sent*/
+        ( void ) CanTp_Frame( hcantp, Frame, ( uint8_t ) Length + 1u );
+
+        hcantp->TxCount += Length;
+        hcantp->TxSn = ( hcantp->TxSn + 1u ) & 0x0Fu;
+        hcantp->TxTick = HAL_GetTick();
+
+        if( hcantp->TxCount == hcantp->TxSize ) {
+            hcantp->TxState = CANTP_IDLE;
+        }
+        else if( ( hcantp->TxBlockSize != 0u ) && ( --hcantp->TxBlock == 0u ) ) {
+            hcantp->TxState = CANTP_TX_WAIT_FC;
+        }
+        else if( hcantp->TxStmin != 0u ) {
+            /*The tick changes at most once per ms, the loop can not go on until the next call*/
+            break;
+        }
+        else {
+            /*Next frame of the block*/
+        }
+    }
+}
+
+/**
+ * @brief   **Function that converts the STmin of a flow control to ms.**
+ *
+ * The values from 0xF1 to 0xF9 are 100 to 900 us and are rounded up to 1 ms, the reserved values are
+ * taken as the longest time, 127 ms.
+ *
+ * @param   <stmin[in]> STmin of the flow control frame.
+ *
+ * @retval  Separation time in ms.
+ */
+
+static uint8_t CanTp_Stmin( uint8_t stmin ) {
+    uint8_t Time;
+
+    if( stmin <= 0x7Fu ) {
+        Time = stmin;
+    }
+    else if( ( stmin >= 0xF1u ) && ( stmin <= 0xF9u ) ) {
+        Time = 1u;
+    }
+    else {
+        Time = 0x7Fu;
+    }
+
+    return Time;
+}
+
+/**
+ * @brief   **Function that gives the bytes of the data field of a DLC.**
+ *
+ * @param   <dlc[in]> DLC as given by the HAL, FDCAN_DLC_BYTES_0 to FDCAN_DLC_BYTES_64.
+ *
+ * @retval  Bytes of the data field.
+ */
+
+uint8_t CanTp_Length( uint32_t dlc ) {
+    /*The HAL keeps the DLC in the bits 16 to 19*/
+    return CanTp_DlcBytes[ ( dlc >> 16 ) & 0x0Fu ];
+}
+
+/**
+ * @brief   **Function that gives the shortest DLC that holds a number of bytes.**
+ *
+ * Classic CAN always takes 8 bytes, the frames of the transport are padded up to it.
+ *
+ * @param   <length[in]> Bytes of the data field.
+ *
+ * @retval  DLC as expected by the HAL.
+ */
+
+uint32_t CanTp_Dlc( uint8_t length ) {
+    uint32_t Dlc = 8u;
+
+#if SERIAL_CAN_FD == 1
+    while( ( Dlc < 15u ) && ( CanTp_DlcBytes[ Dlc ] < length ) ) {
+        Dlc++;
+    }
+#else
+    ( void ) length;
+#endif
+
+    return Dlc << 16;
+}
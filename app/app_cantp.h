@@ -0,0 +1,61 @@
+/**
+ * @file    app_cantp.h
+ * @brief   **This file declares the functions of the ISO-TP (ISO 15765-2) transport of the CAN link.**
+ *
+ * Messages of up to 7 bytes go in a single frame, longer ones are split in a first frame and
+ * consecutive frames, paced by the flow control frames of the receiver with a block size and a
+ * minimum separation time (STmin). The reassembly and transmission buffers are sized at compile time
+ * with CANTP_RX_SIZE and CANTP_TX_SIZE. With SERIAL_CAN_FD the frames carry up to 64 bytes.
+ */
+
+#ifndef APP_CANTP_H__
+#define APP_CANTP_H__
+
+#include "app_bsp.h"
+
+/**
+ * @defgroup <States of the reception and the transmission of a multi-frame message.>
+ @{ */
+#define CANTP_IDLE          0u  /*!< No multi-frame message in progress.*/
+#define CANTP_RX_CF         1u  /*!< Waiting for the consecutive frames of a message.*/
+#define CANTP_TX_WAIT_FC    2u  /*!< Waiting for the flow control of the receiver.*/
+#define CANTP_TX_CF         3u  /*!< Sending the consecutive frames of a block.*/
+/**
+ @} */
+
+/**
+ * @brief Structure with the state of a transport connection.
+*/
+typedef struct
+{
+    FDCAN_HandleTypeDef     *Fdcan;         /**< CAN module used to send the frames.                     */
+    FDCAN_TxHeaderTypeDef   *TxHeader;      /**< Header of the frames sent.                               */
+    uint8_t     RxBuffer[ CANTP_RX_SIZE ];  /**< Reassembly buffer of the messages received.              */
+    uint16_t    RxSize;                     /**< Size of the message being received.                      */
+    uint16_t    RxCount;                    /**< Bytes of the message received so far.                    */
+    uint8_t     RxSn;                       /**< Sequence number of the next consecutive frame.           */
+    uint8_t     RxBlock;                    /**< Consecutive frames left before sending a flow control.   */
+    uint8_t     RxDl;                       /**< Length of the first frame and of the consecutive frames. */
+    uint8_t     RxState;                    /**< CANTP_IDLE or CANTP_RX_CF.                               */
+    uint32_t    RxTick;                     /**< Tick of the last frame received, for the timeout.        */
+    uint8_t     TxBuffer[ CANTP_TX_SIZE ];  /**< Copy of the message being sent.                          */
+    uint16_t    TxSize;                     /**< Size of the message being sent.                          */
+    uint16_t    TxCount;                    /**< Bytes of the message sent so far.                        */
+    uint8_t     TxSn;                       /**< Sequence number of the next consecutive frame.           */
+    uint8_t     TxBlockSize;                /**< Block size asked by the receiver, 0 for no limit.        */
+    uint8_t     TxBlock;                    /**< Consecutive frames left in the current block.            */
+    uint8_t     TxStmin;                    /**< Separation time in ms asked by the receiver.             */
+    uint8_t     TxState;                    /**< CANTP_IDLE, CANTP_TX_WAIT_FC or CANTP_TX_CF.             */
+    uint32_t    TxTick;                     /**< Tick of the last frame sent or flow control received.    */
+    uint8_t     FcPending;                  /**< Flow status waiting for room in the Tx Fifo, or none.    */
+    uint32_t    TxDrops;                    /**< Messages not sent because the Tx Fifo was full.          */
+} CANTP_HandleTypeDef;
+
+void CanTp_Init( CANTP_HandleTypeDef *hcantp );
+uint8_t CanTp_Rx( CANTP_HandleTypeDef *hcantp, uint8_t *frame, uint8_t length, uint8_t **data, uint16_t *size );
+uint8_t CanTp_Send( CANTP_HandleTypeDef *hcantp, const uint8_t *data, uint16_t size );
+void CanTp_Task( CANTP_HandleTypeDef *hcantp );
+uint8_t CanTp_Length( uint32_t dlc );
+uint32_t CanTp_Dlc( uint8_t length );
+
+#endif
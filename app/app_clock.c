@@ -13,17 +13,14 @@
   @{*/
 #define IDLE        0 /*!< First state of the clock states.*/
 #define RECEPTION   1 /*!< Second state of the clock states.*/
-#define ALARM       2 /*!< Third state of the clock states.*/
-#define DATE        3 /*!< Fourth state of the clock states.*/
-#define TIME        4 /*!< Fifth state of the clock states.*/
-#define CLEAR       5 /*!< Sixth state of the clock states.*/
-#define MESSAGE     6 /*!< Seventh state of the clock states.*/
+#define MESSAGE     2 /*!< Third state of the clock states.*/
 /**@}*/
 
 static void SaveTime( void );
 static void SaveDate( void );
 static void SaveAlarm( void );
 static void ClearStorage( void );
+static void SaveMessage( void );
 static void UpdateAndPrint( void );
 static uint32_t Clock_Machine( uint32_t currentState ); 
 
@@ -68,15 +65,15 @@ RTC_AlarmTypeDef        sAlarm = {0};
 APP_MsgTypeDef ClockMsg = {0};
 
 /**
- * @brief Struct variable of Queue elements
+ * @brief Struct variable of Queue elements, the buffer is part of it
 */
-QUEUE_HandleTypeDef ClockQueue = {0};
+QUEUE_Clock_TypeDef ClockQueue = {0};
 
 /**
- * @brief Struct variable with the array of Queue
+ * @brief Message block read from the queue, it is given back to the pool once it is saved in the RTC
 */
-/* cppcheck-suppress misra-c2012-8.7 ;If header is modified the program will not work*/
-NEW_MsgTypeDef buffer_clock[45];  /* cppcheck-suppress misra-c2012-8.4 ;Its been used due to the queue*/
+extern APP_MsgTypeDef *ClockData;
+APP_MsgTypeDef *ClockData = NULL;
 
 
 /**
@@ -87,10 +84,7 @@ NEW_MsgTypeDef buffer_clock[45];  /* cppcheck-suppress misra-c2012-8.4 ;Its been
 
 void Clock_Init( void )
 {
-    ClockQueue.Buffer = (void*)buffer_clock;    /*Indicate the buffer that the tail will use as memory space*/
-    ClockQueue.Elements = 45u;                  /*Indicate the maximum number of elements that can be stored*/ 
-    ClockQueue.Size = sizeof( NEW_MsgTypeDef ); /*Indicate the size in bytes of the type of elements to handle*/ 
-    HIL_QUEUE_Init( &ClockQueue );              /*Initialize the queue*/ 
+    HIL_QUEUE_InitClock( &ClockQueue );         /*Initialize the queue*/ 
 
     HAL_StatusTypeDef Status;
 
@@ -142,17 +136,20 @@ void Clock_Init( void )
 
 /**
 * @brief Clock task function 
-* This function checks the queue of pending tasks every 50ms and process them calling the clock machine   
+* This function runs the clock machine every 50ms, every run saves all the messages waiting in the queue
+* and then updates the display.
 */
 
 void Clock_Task(void) {
-   static uint32_t state = RECEPTION;
+   static uint32_t state = IDLE;
    static uint32_t serialtick =0;
    /* We check the waiting queue with 50ms */
    if ((HAL_GetTick() - serialtick) >= 50u) {
        serialtick = HAL_GetTick(); 
        
-        state = Clock_Machine(state);
+       do {
+            state = Clock_Machine(state);
+       } while( state != IDLE );
    }
 }
 
@@ -160,13 +157,15 @@ void Clock_Task(void) {
  * @brief   **Functon with the state machine that manages the Clock set & display.**
  *
  * The state machine calls functions that passes the new values of time, date and alarm that come through
- * the CAN bus to the RTC, then clears the struct that was readed, and finally, displays this data 
- * every second. More details are shown in the diagram.
+ * the CAN bus to the RTC, all the messages waiting in the queue in the same run, then gives their blocks
+ * back to the pool, and finally, displays this data. More details are shown in the diagram.
  */
 
 static uint32_t Clock_Machine( uint32_t currentState )
 {
     uint32_t StateClock = currentState;
+    static APP_MsgRefTypeDef Pending[ APP_MSG_BLOCKS ];    /*Kept off the stack, the pool can be large*/
+    uint32_t Count;
 
     switch( StateClock )
     {
@@ -175,46 +174,14 @@ static uint32_t Clock_Machine( uint32_t currentState )
         break;
 
         case RECEPTION:
-            /*Revision and unpaked the messages */
-           if( HIL_QUEUE_IsEmptyISR( &ClockQueue, 0xFF ) == ( uint8_t ) 0 )
+            /*All the messages waiting are taken at once, in the order they arrived*/
+            Count = HIL_QUEUE_ReadNClockISR( &ClockQueue, Pending, APP_MSG_BLOCKS, 0xFF );
+            for( uint32_t i = 0; i < Count; i++ )
             {
-                /*Read the first message*/
-                (void)HIL_QUEUE_ReadISR( &ClockQueue, &DataStorage, 0xFF );
-
-                if(DataStorage.msg == (uint8_t)SERIAL_MSG_TIME) {
-                    StateClock = TIME;
-                }
-                else if(DataStorage.msg == (uint8_t)SERIAL_MSG_DATE) {
-                    StateClock = DATE;
-                }
-                else if(DataStorage.msg == (uint8_t)SERIAL_MSG_ALARM) {
-                    StateClock = ALARM;
-                }
-                else{    
-                }
+                ClockData = Pending[i];
+                SaveMessage();
+                ClearStorage();
             }
-            else{ 
-                StateClock = MESSAGE;
-            }
-        break;
-
-        case ALARM:
-            SaveAlarm();
-            StateClock = CLEAR;
-        break;
-
-        case DATE:
-            SaveDate();
-            StateClock = CLEAR;
-        break;
-
-        case TIME:
-            SaveTime();
-            StateClock = CLEAR;
-        break;
-
-        case CLEAR:
-            ClearStorage();
             StateClock = MESSAGE;
         break;
 
@@ -231,19 +198,40 @@ static uint32_t Clock_Machine( uint32_t currentState )
     return StateClock;
 }
 
+/**
+ * @brief   **Function that passes the message block ClockData to the RTC module.**
+ *
+ * An unknown message type is not saved, its block is given back all the same.
+ */
+
+static void SaveMessage( void ) {
+    if( ClockData->msg == ( uint8_t ) SERIAL_MSG_TIME ) {
+        SaveTime();
+    }
+    else if( ClockData->msg == ( uint8_t ) SERIAL_MSG_DATE ) {
+        SaveDate();
+    }
+    else if( ClockData->msg == ( uint8_t ) SERIAL_MSG_ALARM ) {
+        SaveAlarm();
+    }
+    else {
+        /*Nothing to save*/
+    }
+}
+
 /**
  * @brief   **Function that passes time values to the RTC module.**
  *
- * The function reads the struct DataStorage to assign it's values to the strcut that feeds the RTC
+ * The function reads the message block ClockData to assign it's values to the strcut that feeds the RTC
  * time initial values.
  */
 
 static void SaveTime( void ) {
     HAL_StatusTypeDef Status;
 
-    sTime.Hours   = DataStorage.tm.tm_hour;
-    sTime.Minutes = DataStorage.tm.tm_min;
-    sTime.Seconds = DataStorage.tm.tm_sec;
+    sTime.Hours   = ClockData->tm.tm_hour;
+    sTime.Minutes = ClockData->tm.tm_min;
+    sTime.Seconds = ClockData->tm.tm_sec;
     sTime.DayLightSaving = RTC_DAYLIGHTSAVING_NONE;
     sTime.StoreOperation = RTC_STOREOPERATION_RESET;
 
@@ -256,18 +244,18 @@ static void SaveTime( void ) {
 /**
  * @brief   **Function that passes date values to the RTC module.**
  *
- * The function reads the struct DataStorage to assign it's values to the strcut that feeds the RTC
+ * The function reads the message block ClockData to assign it's values to the strcut that feeds the RTC
  * date initial values.
  */
 
 static void SaveDate( void ) {
     HAL_StatusTypeDef Status;
 
-    sDate.WeekDay = DataStorage.tm.tm_wday;
-    sDate.Date = DataStorage.tm.tm_mday;
-    sDate.Month = DataStorage.tm.tm_mon;
-    sDate.Year = DataStorage.tm.tm_year % ( uint32_t ) 100;
-    dateYearH = DataStorage.tm.tm_year / ( uint32_t ) 100;
+    sDate.WeekDay = ClockData->tm.tm_wday;
+    sDate.Date = ClockData->tm.tm_mday;
+    sDate.Month = ClockData->tm.tm_mon;
+    sDate.Year = ClockData->tm.tm_year % ( uint32_t ) 100;
+    dateYearH = ClockData->tm.tm_year / ( uint32_t ) 100;
 
     /*The function is used and its result is verified.*/
     Status = HAL_RTC_SetDate( &RtcHandler, &sDate, RTC_FORMAT_BIN);
@@ -278,7 +266,7 @@ static void SaveDate( void ) {
 /**
  * @brief   **Function that passes alarm values to the RTC module.**
  *
- * The function reads the struct DataStorage to assign it's values to the strcut that feeds the RTC
+ * The function reads the message block ClockData to assign it's values to the strcut that feeds the RTC
  * alarm initial values.
  */
 
@@ -286,8 +274,8 @@ static void SaveAlarm( void ) {
     HAL_StatusTypeDef Status;
 
     sAlarm.Alarm = RTC_ALARM_A;
-    sAlarm.AlarmTime.Hours = DataStorage.tm.tm_hour_a;
-    sAlarm.AlarmTime.Minutes = DataStorage.tm.tm_min_a;
+    sAlarm.AlarmTime.Hours = ClockData->tm.tm_hour_a;
+    sAlarm.AlarmTime.Minutes = ClockData->tm.tm_min_a;
 
     /*The function is used and its result is verified.*/
     Status = HAL_RTC_SetAlarm( &RtcHandler, &sAlarm, RTC_FORMAT_BIN );
@@ -296,14 +284,15 @@ static void SaveAlarm( void ) {
 }
 
 /**
- * @brief   **Function that sets the entire DataStorage struct to 0.**
+ * @brief   **Function that gives the message block back to the pool.**
  *
- * The function clears all of the existing values of the DataStorage struct.
+ * The function clears all of the existing values of the block before giving it back.
  */
 
 static void ClearStorage( void ) {
-    APP_MsgTypeDef nullMessageStruct = {0};
-    DataStorage = nullMessageStruct;
+    ( void ) memset( ClockData, 0, sizeof( APP_MsgTypeDef ) );
+    HIL_POOL_Free( &MsgPool, ClockData );
+    ClockData = NULL;
 }
 
 
@@ -342,7 +331,8 @@ static void UpdateAndPrint( void ) {
     ClockMsg.tm.tm_year = ( ( ( uint32_t ) dateYearH * ( uint32_t ) 100 ) + ( uint32_t ) sDate.Year );
     ClockMsg.tm.tm_wday = sDate.WeekDay;
 
-    (void) HIL_QUEUE_WriteISR( &DisplayQueue, &DataStorage, 0xFF );
-
     ClockMsg.msg = 1;
+
+    /*The display only needs the latest snapshot, an unread one is replaced.*/
+    HIL_QUEUE_OverwriteDisplayISR( &DisplayQueue, &ClockMsg, 0xFF );
 }
\ No newline at end of file
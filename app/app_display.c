@@ -36,6 +36,16 @@ static void DateString(char *string, unsigned char month, unsigned char day, uns
 static void TimeString(char *string, unsigned char hours, unsigned char minutes, unsigned char seconds);
 static void Display_Machine( void );
 
+/**
+ * @brief  State of the LCD initialization coroutine.
+ */
+static Coroutine_TypeDef LcdInit = {0};
+
+/**
+ * @brief  Flag set once the LCD initialization finished.
+ */
+static uint8_t LcdReady = 0;
+
 static char TimeArray[9];
 static char DateArray[16];
 
@@ -57,20 +67,10 @@ char *DateArrayPtr = DateArray;
  * @brief Struct variable of Queue elements
 */
 
-QUEUE_HandleTypeDef DisplayQueue = {0};    
-
-/**
- * @brief Struct variable with the array of Queue
-*/
-
-/* cppcheck-suppress misra-c2012-8.7 ;If header is modified the program will not work*/
-NEW_MsgTypeDef buffer_display[90];  /* cppcheck-suppress misra-c2012-8.4 ;Its been used due to the queue*/
+QUEUE_Display_TypeDef DisplayQueue = {0};    
 
 void Display_Init( void ) {
-    DisplayQueue.Buffer = (void*)buffer_display;  /*Indicate the buffer that the tail will use as memory space*/
-    DisplayQueue.Elements = 90u;                  /*Indicate the maximum number of elements that can be stored*/ 
-    DisplayQueue.Size = sizeof( NEW_MsgTypeDef ); /*Indicate the size in bytes of the type of elements to handle*/
-    HIL_QUEUE_Init( &DisplayQueue );              /*Initialize the queue*/
+    HIL_QUEUE_InitDisplay( &DisplayQueue );       /*Initialize the queue*/
     HAL_StatusTypeDef Status;
 
     /*Configuration of pins and port with the LCD struc*/
@@ -104,18 +104,25 @@ void Display_Init( void ) {
     /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
     assert_error( Status == HAL_OK, SPI_RET_ERROR );
 
-    (void)HEL_LCD_Init(&hLcd);
+    /*The LCD initialization runs from Display_Task, its delays don't block the rest of the tasks.*/
+    COROUTINE_INIT( &LcdInit );
 }
 
 
 /**
 * @brief Display task function 
 * This function checks the queue of pending tasks every 100ms and process them calling the display machine   
+* Until the LCD is ready every call moves its initialization up to the next delay, the messages wait in the queue.
 */
 void Display_Task(void) {
    static uint32_t serialtick =0;
 
-   if ((HAL_GetTick() - serialtick) >= 100u) {
+   if (LcdReady == 0u) {
+       if (HEL_LCD_InitAsync( &hLcd, &LcdInit ) == ( uint8_t ) COROUTINE_DONE) {
+           LcdReady = 1;
+       }
+   }
+   else if ((HAL_GetTick() - serialtick) >= 100u) {
        serialtick = HAL_GetTick(); 
        
         Display_Machine();
@@ -130,10 +137,9 @@ static void Display_Machine( void ) {
 
         case RECEPTION:
             /*Revision and unpaked the messages */
-           if( HIL_QUEUE_IsEmptyISR( &DisplayQueue, 0xFF ) == 0u )
+            /*Read the first message*/
+            if( HIL_QUEUE_ReadDisplayISR( &DisplayQueue, &ClockMsg, 0xFF ) == ( uint8_t ) QUEUE_OK )
             {
-                /*Read the first message*/
-                (void)HIL_QUEUE_ReadISR( &DisplayQueue, &ClockMsg, 0xFF);
 
                 state_lcd = TRANSMIT;               
             }
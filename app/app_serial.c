@@ -50,9 +50,8 @@ static uint8_t WeekDay( uint8_t *Data );
 uint16_t YearDay(uint8_t *Data );
 static uint8_t DaylightSavingTime( uint8_t *Data );
 static uint8_t AlarmValidaton( uint8_t *Data );
-static void CanTp_SingleFrameTx( uint8_t *Data, uint8_t Size );
-static uint8_t CanTp_SingleFrameRx( uint8_t *Data, uint8_t *Size );
 static uint32_t Serial_Machine(uint32_t currentState);
+static uint32_t SendMessage( void );
 
 /**
   * @brief   Structure that will contain the values to initialice the CAN module.
@@ -81,10 +80,11 @@ extern FDCAN_FilterTypeDef     CANFilter;
 FDCAN_FilterTypeDef     CANFilter   = {0};
 
 /**
-  * @brief   Structure that contains the type of message received and it's values.
+  * @brief   Message block being filled, taken from the pool and handed to the clock task by pointer.
   */
 
-APP_MsgTypeDef  DataStorage = {0};
+extern APP_MsgTypeDef *DataStorage;
+APP_MsgTypeDef *DataStorage = NULL;
 
 /**
   * @brief   Enum that defines which type of message is received by the CAN bus.
@@ -96,30 +96,31 @@ APP_Messages    MessageType;
  * @brief  Variable that will contain the data received in the Fifo0 buffer.
  */
 
-extern uint8_t RxData[8];
-uint8_t RxData[8]       = {0};
+extern uint8_t RxData[CAN_FRAME_SIZE];
+uint8_t RxData[CAN_FRAME_SIZE] = {0};
 
 
 /**
- * @brief  Variable that will contain the unpacked CAN message.
+ * @brief  Pointer to the unpacked CAN message, inside the frame of the queue for a single frame or in
+ * the reassembly buffer of the transport for a longer message.
  */
 
-extern uint8_t MessageData[7];
-uint8_t MessageData[7]  = {0};
+extern uint8_t *MessageData;
+uint8_t *MessageData    = NULL;
 
 /**
  * @brief  Variable that will contain the size number of the received CAN message.
  */
 
-extern uint8_t MessageSize;
-uint8_t MessageSize     = 0;
+extern uint16_t MessageSize;
+uint16_t MessageSize    = 0;
 
 /**
- * @brief  Variable that will contain the flag the flag that warns if there is a new message.
+ * @brief  ISO-TP transport of the CAN link.
  */
 
-extern uint8_t Message;
-uint8_t Message         = 0;
+extern CANTP_HandleTypeDef CanTp;
+CANTP_HandleTypeDef CanTp = {0};
 
 /**
  * @brief  Variable for the change of the cases of the switch of the state machine.
@@ -138,19 +139,32 @@ QUEUE_HandleTypeDef CanQueue = {0};
  * @brief Struct variable with the array of Queue
 */
 /* cppcheck-suppress misra-c2012-8.7 ;If header is modified the program will not work*/
-NEW_MsgTypeDef buffer_serial[9];  /* cppcheck-suppress misra-c2012-8.4 ;Its been used due to the queue*/
+NEW_MsgTypeDef buffer_serial[QUEUE_ELEMENTS];  /* cppcheck-suppress misra-c2012-8.4 ;Its been used due to the queue*/
 
 /**
- * @brief Struct variable with array to save the elements
+ * @brief Pointer to the frame being processed, it stays in the queue until the machine is done with it
 */
-extern NEW_MsgTypeDef RxBuffer;
-NEW_MsgTypeDef RxBuffer = {0};
+extern NEW_MsgTypeDef *RxBuffer;
+NEW_MsgTypeDef *RxBuffer = NULL;
+
+/**
+ * @brief Counters of the CAN reception, written by the interrupt
+*/
+static volatile SERIAL_RxStatsTypeDef RxStats = {0};
+
+/**
+ * @brief Pool of the message blocks and its memory space
+*/
+POOL_HandleTypeDef MsgPool = {0};
+/* cppcheck-suppress misra-c2012-8.7 ;If header is modified the program will not work*/
+APP_MsgTypeDef buffer_msg[APP_MSG_BLOCKS];  /* cppcheck-suppress misra-c2012-8.4 ;Its been used due to the pool*/
 
 /**
  * @brief   **Function that initialices the registers of the CAN communication protocol.**
  *
- * CAN frame is configured as Classic, the transmition identifier is set witht the value 0x122, and the
- * filter is set to accept only messages with the identifier 0x111.
+ * CAN frame is configured as Classic, or as CAN FD with bit rate switching when SERIAL_CAN_FD is 1, the
+ * transmition identifier is set witht the value 0x122, and the filter is set to accept only messages
+ * with the identifier 0x111.
  */
 
 void Serial_Init( void )
@@ -158,19 +172,33 @@ void Serial_Init( void )
     CanQueue.Buffer = (void*)buffer_serial;     /*Indicate the buffer that the tail will use as memory space*/
     CanQueue.Elements = QUEUE_ELEMENTS;         /*Indicates the maximum number of elements that can be stored*/ 
     CanQueue.Size = sizeof( NEW_MsgTypeDef );   /*Indicate the size in bytes of the type of elements to handle*/ 
-    HIL_QUEUE_Init( &CanQueue );                /*Initialize the queue*/ 
+    HIL_QUEUE_InitSPSC( &CanQueue );            /*Initialize the queue, written by the CAN interrupt and read by the task*/
+
+    MsgPool.Buffer = (void*)buffer_msg;         /*Indicate the buffer split in message blocks*/
+    MsgPool.Blocks = APP_MSG_BLOCKS;            /*Indicates the number of messages in flight at the same time*/
+    MsgPool.Size = sizeof( APP_MsgTypeDef );    /*Indicate the size in bytes of every block*/
+    HIL_POOL_Init( &MsgPool );                  /*Initialize the pool, the clock task gives the blocks back*/
 
     HAL_StatusTypeDef Status;
 
     CANHandler.Instance                     = FDCAN1;
     CANHandler.Init.Mode                    = FDCAN_MODE_NORMAL;
+#if SERIAL_CAN_FD == 1
+    CANHandler.Init.FrameFormat             = FDCAN_FRAME_FD_BRS;
+#else
     CANHandler.Init.FrameFormat             = FDCAN_FRAME_CLASSIC;
+#endif
     CANHandler.Init.ClockDivider            = FDCAN_CLOCK_DIV1;
     CANHandler.Init.TxFifoQueueMode         = FDCAN_TX_FIFO_OPERATION;
     CANHandler.Init.NominalPrescaler        = 20;
     CANHandler.Init.NominalSyncJumpWidth    = 1;
     CANHandler.Init.NominalTimeSeg1         = 11;
     CANHandler.Init.NominalTimeSeg2         = 4;
+    /*Kernel clock PCLK = 32 MHz, nominal = 32 MHz / 20 / 16 tq = 100 kbit/s, data = 32 MHz / 2 / 16 tq = 1 Mbit/s*/
+    CANHandler.Init.DataPrescaler           = 2;
+    CANHandler.Init.DataSyncJumpWidth       = 4;
+    CANHandler.Init.DataTimeSeg1            = 11;
+    CANHandler.Init.DataTimeSeg2            = 4;
     CANHandler.Init.StdFiltersNbr           = 1;
 
     /*The function is used and its result is verified.*/
@@ -178,8 +206,26 @@ void Serial_Init( void )
     /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
     assert_error( Status == HAL_OK, CAN_RET_ERROR );
 
+#if SERIAL_CAN_FD == 1
+    /*The transceiver delay is compensated at the sample point of the data phase, in mtq*/
+    /*The function is used and its result is verified.*/
+    Status = HAL_FDCAN_ConfigTxDelayCompensation( &CANHandler, CANHandler.Init.DataPrescaler * CANHandler.Init.DataTimeSeg1, 0 );
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( Status == HAL_OK, CAN_RET_ERROR );
+
+    /*The function is used and its result is verified.*/
+    Status = HAL_FDCAN_EnableTxDelayCompensation( &CANHandler );
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( Status == HAL_OK, CAN_RET_ERROR );
+#endif
+
     CANTxHeader.IdType      = FDCAN_STANDARD_ID;
+#if SERIAL_CAN_FD == 1
+    CANTxHeader.FDFormat    = FDCAN_FD_CAN;
+    CANTxHeader.BitRateSwitch = FDCAN_BRS_ON;
+#else
     CANTxHeader.FDFormat    = FDCAN_CLASSIC_CAN;
+#endif
     CANTxHeader.TxFrameType = FDCAN_DATA_FRAME;
     CANTxHeader.DataLength  = FDCAN_DLC_BYTES_8;
 
@@ -208,20 +254,30 @@ void Serial_Init( void )
     assert_error( Status == HAL_OK, CAN_RET_ERROR );
 
     /*The function is used and its result is verified.*/
-    Status = HAL_FDCAN_ActivateNotification( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE, 0 );
+    Status = HAL_FDCAN_ActivateNotification( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE | FDCAN_IT_RX_FIFO0_FULL | FDCAN_IT_RX_FIFO0_MESSAGE_LOST, 0 );
     /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
     assert_error( Status == HAL_OK, CAN_RET_ERROR );
+
+    CanTp.Fdcan = &CANHandler;                  /*Indicate the CAN module that sends the frames*/
+    CanTp.TxHeader = &CANTxHeader;              /*Indicate the header of the frames, the transport sets the length*/
+    CanTp_Init( &CanTp );
 }
 
+/**
+* @brief Serial task function 
+* This function runs the serial machine until the queue of received frames is empty, it is called 
+* every 10ms by the scheduler and right away when the CAN interrupt notifies a new frame. A frame is
+* only taken with room in the Tx Fifo for its answer, otherwise it waits in the queue for the next call.
+*/
+
 void Serial_Task(void) {
-   static uint32_t state = RECEPTION;
-   static uint32_t serialtick =0;
-   /* We check the waiting queue with 10ms */
-   if ((HAL_GetTick() - serialtick) >= 10u) {
-       serialtick = HAL_GetTick(); 
-       
+   static uint32_t state = IDLE;
+
+   CanTp_Task( &CanTp );
+
+   do {
         state = Serial_Machine(state);
-   }
+   } while( state != IDLE );
 }
 
 /**
@@ -242,24 +298,29 @@ static uint32_t Serial_Machine( uint32_t currentState )
 
     switch( State ) {
         case IDLE:
-            /*if( CanTp_SingleFrameRx( MessageData, &MessageSize ) == ( uint8_t ) 1 ) {
-                State = MESSAGE;
-            }*/
             State = RECEPTION;
         break;
 
         case RECEPTION:
-            /*Revision and unpaked the messages */
-           if( HIL_QUEUE_IsEmptyISR( &CanQueue, TIM16_FDCAN_IT0_IRQn ) == ( uint8_t ) 0 )
+            /*Take the first message in place, the CAN interrupt stays enabled*/
+            RxBuffer = ( HAL_FDCAN_GetTxFifoFreeLevel( &CANHandler ) != 0u ) ? HIL_QUEUE_Peek( &CanQueue ) : NULL;
+            if( RxBuffer != NULL )
             {
-                /*Read the first message*/
-                (void)HIL_QUEUE_ReadISR( &CanQueue, &RxBuffer, TIM16_FDCAN_IT0_IRQn );
-
                 /*Revision and unpaked the messages */
-                if( CanTp_SingleFrameRx( RxBuffer.data, &MessageSize) == ( uint8_t ) 1 )
+                if( CanTp_Rx( &CanTp, RxBuffer->data, RxBuffer->length, &MessageData, &MessageSize ) == ( uint8_t ) 1 )
                 {
+                    /*A longer message is in the reassembly buffer, the last frame is not needed*/
+                    if( MessageData == CanTp.RxBuffer )
+                    {
+                        HIL_QUEUE_Release( &CanQueue );
+                        RxBuffer = NULL;
+                    }
                     State = MESSAGE;
                 }
+                else
+                {
+                    HIL_QUEUE_Release( &CanQueue );
+                }
             }else{
                 
                 State = IDLE;
@@ -267,16 +328,21 @@ static uint32_t Serial_Machine( uint32_t currentState )
         break;
 
         case MESSAGE:
-            if( RxBuffer.data[0] == ( uint8_t ) SERIAL_MSG_TIME ) {
-                DataStorage.msg = SERIAL_MSG_TIME;
+            DataStorage = HIL_POOL_Alloc( &MsgPool );
+
+            if( DataStorage == NULL ) {
+                State = ERROR;
+            }
+            else if( MessageData[0] == ( uint8_t ) SERIAL_MSG_TIME ) {
+                DataStorage->msg = SERIAL_MSG_TIME;
                 State = TIME;
             }
-            else if( RxBuffer.data[0] == ( uint8_t ) SERIAL_MSG_DATE ) {
-                DataStorage.msg = SERIAL_MSG_DATE;
+            else if( MessageData[0] == ( uint8_t ) SERIAL_MSG_DATE ) {
+                DataStorage->msg = SERIAL_MSG_DATE;
                 State = DATE;
             }
-            else if( RxBuffer.data[0] == ( uint8_t ) SERIAL_MSG_ALARM ) {
-                DataStorage.msg = SERIAL_MSG_ALARM;
+            else if( MessageData[0] == ( uint8_t ) SERIAL_MSG_ALARM ) {
+                DataStorage->msg = SERIAL_MSG_ALARM;
                 State = ALARM;
             }
             else {
@@ -285,11 +351,9 @@ static uint32_t Serial_Machine( uint32_t currentState )
         break;
 
         case TIME:
-            if( TimeValidaton( RxBuffer.data ) == ( uint8_t ) 1 ) {
+            if( TimeValidaton( MessageData ) == ( uint8_t ) 1 ) {
 
-                (void) HIL_QUEUE_WriteISR( &ClockQueue, &DataStorage, 0xFF );
-                
-                State = OK;
+                State = SendMessage();
             }
             else {
                 State = ERROR;
@@ -297,15 +361,13 @@ static uint32_t Serial_Machine( uint32_t currentState )
         break;
 
         case DATE:
-            if( DateValidaton( RxBuffer.data ) == ( uint8_t ) 1 ) {
-
-                DataStorage.tm.tm_wday = WeekDay( RxBuffer.data );
-                DataStorage.tm.tm_yday = YearDay( RxBuffer.data );
-                DataStorage.tm.tm_isdst = DaylightSavingTime( RxBuffer.data );
+            if( DateValidaton( MessageData ) == ( uint8_t ) 1 ) {
 
-                (void) HIL_QUEUE_WriteISR( &ClockQueue, &DataStorage, 0xFF );
+                DataStorage->tm.tm_wday = WeekDay( MessageData );
+                DataStorage->tm.tm_yday = YearDay( MessageData );
+                DataStorage->tm.tm_isdst = DaylightSavingTime( MessageData );
 
-                State = OK;
+                State = SendMessage();
             }
             else {
                 State = ERROR;
@@ -313,11 +375,9 @@ static uint32_t Serial_Machine( uint32_t currentState )
         break;
 
         case ALARM:
-            if( AlarmValidaton( RxBuffer.data ) == ( uint8_t ) 1) {
+            if( AlarmValidaton( MessageData ) == ( uint8_t ) 1) {
 
-                (void)HIL_QUEUE_WriteISR( &ClockQueue, &DataStorage, 0xFF );
-
-                State = OK;
+                State = SendMessage();
             }
             else {
                 State = ERROR;
@@ -325,13 +385,25 @@ static uint32_t Serial_Machine( uint32_t currentState )
         break;
 
         case ERROR:
-            CanTp_SingleFrameTx( &MessageERROR, 2 );
-            State = IDLE;
+            if( DataStorage != NULL ) {
+                HIL_POOL_Free( &MsgPool, DataStorage );
+                DataStorage = NULL;
+            }
+            if( RxBuffer != NULL ) {
+                HIL_QUEUE_Release( &CanQueue );
+                RxBuffer = NULL;
+            }
+            ( void ) CanTp_Send( &CanTp, &MessageERROR, 1 );
+            State = RECEPTION;
         break;
 
         case OK:
-            CanTp_SingleFrameTx( &MessageOK, 2 );
-            State = IDLE;
+            if( RxBuffer != NULL ) {
+                HIL_QUEUE_Release( &CanQueue );
+                RxBuffer = NULL;
+            }
+            ( void ) CanTp_Send( &CanTp, &MessageOK, 1 );
+            State = RECEPTION;
         break;
 
         default:
@@ -342,24 +414,84 @@ static uint32_t Serial_Machine( uint32_t currentState )
 }
 
 /**
- * @brief   **Function triggered by the Rx interruption to read the Fifo0 buffer.**
+ * @brief   **Function that hands the message block to the clock task.**
+ *
+ * Only the pointer goes through the queue, the block belongs to the clock task from now on and it
+ * gives it back to the pool. If the queue is full the message is answered as an error and the block
+ * is given back by the ERROR state.
+ *
+ * @retval  Next state of the machine, OK or ERROR
+ */
+
+static uint32_t SendMessage( void ) {
+    uint32_t State = ERROR;
+
+    if( HIL_QUEUE_WriteClockISR( &ClockQueue, &DataStorage, 0xFF ) == ( uint8_t ) QUEUE_OK ) {
+        DataStorage = NULL;
+        State = OK;
+    }
+
+    return State;
+}
+
+/**
+ * @brief   **Function triggered by the Rx interruptions to read the Fifo0 buffer.**
  *
- * A flag is set whenever the interruption happens, and reset in the function that unpacks the
- * message.
+ * The new message, Fifo full and message lost interrupts call it, every frame in the Fifo is saved
+ * in the queue in the same interrupt and the serial task is notified once, so it runs on the next
+ * pass of the scheduler instead of waiting for its period. The overruns of the Fifo are counted.
  */
 
 /* cppcheck-suppress misra-c2012-2.7 ; Function defined by the HAL library. */
 void HAL_FDCAN_RxFifo0Callback( FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo0ITs ){
     HAL_StatusTypeDef Status;
+    NEW_MsgTypeDef *Slot;
 
-    /*The function is used and its result is verified.*/
-    Status = HAL_FDCAN_GetRxMessage( hfdcan, FDCAN_RX_FIFO0, &CANRxHeader, RxData );
-    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
-    assert_error( Status == HAL_OK, CAN_RET_ERROR );
+    if( ( RxFifo0ITs & FDCAN_FLAG_RX_FIFO0_FULL ) != 0u ) {
+        RxStats.full++;
+    }
+    if( ( RxFifo0ITs & FDCAN_FLAG_RX_FIFO0_MESSAGE_LOST ) != 0u ) {
+        RxStats.lost++;
+    }
 
-    (void) HIL_QUEUE_WriteISR( &CanQueue, &RxData, TIM16_FDCAN_IT0_IRQn );
+    while( HAL_FDCAN_GetRxFifoFillLevel( hfdcan, FDCAN_RX_FIFO0 ) > 0u )
+    {
+        Slot = HIL_QUEUE_Reserve( &CanQueue );
 
-    Message = 1;
+        /*The frame goes straight to the queue, with the queue full it is read to RxData and dropped.*/
+        Status = HAL_FDCAN_GetRxMessage( hfdcan, FDCAN_RX_FIFO0, &CANRxHeader, ( Slot != NULL ) ? Slot->data : RxData );
+        if( Status != HAL_OK )
+        {
+            RxStats.errors++;
+            break;
+        }
+
+        RxStats.frames++;
+        if( Slot != NULL )
+        {
+            Slot->length = CanTp_Length( CANRxHeader.DataLength );
+            HIL_QUEUE_Commit( &CanQueue );
+        }
+    }
+
+    (void) HIL_SCHEDULER_Notify( &Sche, SerialTaskID );
+}
+
+/**
+ * @brief   **Function that copies the counters of the CAN reception.**
+ *
+ * The frames dropped with the queue full are counted by the statistics of CanQueue.
+ *
+ * @param   <*stats[out]> Structure where the counters are copied.
+ */
+
+void Serial_GetRxStats( SERIAL_RxStatsTypeDef *stats ) {
+    HAL_NVIC_DisableIRQ( TIM16_FDCAN_IT0_IRQn );
+    stats->frames = RxStats.frames;
+    stats->full   = RxStats.full;
+    stats->lost   = RxStats.lost;
+    stats->errors = RxStats.errors;
+    HAL_NVIC_EnableIRQ( TIM16_FDCAN_IT0_IRQn );
 }
 
 /**
@@ -398,9 +530,9 @@ static uint8_t TimeValidaton( uint8_t *Data ) {
 
     if( ( Hours >= ( uint8_t ) 0 ) && ( Hours < ( uint8_t ) 24 ) && ( Minutes >= ( uint8_t ) 0 ) &&  ( Minutes < ( uint8_t ) 60 ) && ( Seconds >= ( uint8_t ) 0 ) && ( Seconds <  ( uint8_t ) 60 ) ) {
 
-        DataStorage.tm.tm_hour = Hours;
-        DataStorage.tm.tm_min = Minutes;
-        DataStorage.tm.tm_sec = Seconds;
+        DataStorage->tm.tm_hour = Hours;
+        DataStorage->tm.tm_min = Minutes;
+        DataStorage->tm.tm_sec = Seconds;
 
         Flag = 1;
 
@@ -431,14 +563,14 @@ static uint8_t DateValidaton( uint8_t *Data ) {
     uint16_t Year = ( ( uint16_t ) HexToBCD( Data[3] ) * ( uint16_t ) 100 ) + ( uint16_t ) HexToBCD( Data[4] );
 
     if( ( Year > ( uint16_t ) 1900 ) && ( Year < ( uint16_t ) 2100 ) ) {
-        DataStorage.tm.tm_year = Year;
+        DataStorage->tm.tm_year = Year;
 
         if( ( Month >= JAN ) && ( Month <= DEC ) ) {
-            DataStorage.tm.tm_mon = Month;
+            DataStorage->tm.tm_mon = Month;
 
             if( ( Month == JAN ) || ( Month == MAR ) || ( Month == MAY ) || ( Month == JUL )  || ( Month == AUG ) || ( Month == OCT ) || ( Month == DEC ) ) {
                 if( ( Day >= ( uint8_t ) 1 ) &&  ( Day <= ( uint8_t ) 31 ) ) {
-                    DataStorage.tm.tm_mday = Day;
+                    DataStorage->tm.tm_mday = Day;
                     Flag = 1;
                 }
                 else {
@@ -448,7 +580,7 @@ static uint8_t DateValidaton( uint8_t *Data ) {
 
             else if( ( Month == APR ) || ( Month == JUN ) || ( Month == SEP ) ||  ( Month == NOV ) ) {
                 if( ( Day >= ( uint8_t ) 1 ) && ( Day <= ( uint8_t ) 30 ) ) {
-                    DataStorage.tm.tm_mday = Day;
+                    DataStorage->tm.tm_mday = Day;
                     Flag = 1;
                 }
                 else {
@@ -458,7 +590,7 @@ static uint8_t DateValidaton( uint8_t *Data ) {
 
             else if( ( ( ( Year % ( uint16_t ) 4 ) ) == ( uint16_t ) 0 ) && ( Month == ( uint16_t ) FEB ) ) {
                 if( ( Day >= ( uint8_t ) 1 ) && ( Day <= ( uint8_t ) 29 ) ) {
-                    DataStorage.tm.tm_mday = Day;
+                    DataStorage->tm.tm_mday = Day;
                     Flag = 1;
                 }
                 else {
@@ -468,7 +600,7 @@ static uint8_t DateValidaton( uint8_t *Data ) {
 
             else if ( Month == FEB ) {
                 if( ( Day >= ( uint8_t ) 1 ) && ( Day <= ( uint8_t ) 28 ) ) {
-                    DataStorage.tm.tm_mday = Day;
+                    DataStorage->tm.tm_mday = Day;
                     Flag = 1;
                 }
                 else {
@@ -692,8 +824,8 @@ static uint8_t AlarmValidaton( uint8_t *Data ) {
     uint8_t Minutes = HexToBCD( Data[2] );
 
     if( ( Hours >= ( uint16_t ) 0 ) && ( Hours < ( uint16_t ) 24 ) && ( Minutes >= ( uint16_t ) 0 ) && ( Minutes < ( uint16_t ) 60 ) ) {
-        DataStorage.tm.tm_hour_a = Hours;
-        DataStorage.tm.tm_min_a = Minutes;
+        DataStorage->tm.tm_hour_a = Hours;
+        DataStorage->tm.tm_min_a = Minutes;
         Flag = 1;
     }
     else {
@@ -702,70 +834,3 @@ static uint8_t AlarmValidaton( uint8_t *Data ) {
 
     return Flag;
 }
-
-/**
- * @brief   **Function to pack and send the OK or ERROR message.**
- * 
- * The message is packed into an 8 bit - 8 element array and sent to the Tx Fifo buffer afterwards.
- *
- * @param   <*Data[in]> This pointer has the address of the OK or ERROR message.
- * @param   <Size[in]> This variable must have the size # of the message that the user wants to send.
- */
-
-static void CanTp_SingleFrameTx( uint8_t *Data, uint8_t Size ) {
-    HAL_StatusTypeDef Status;
-    uint8_t MessageOutput[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-
-    for( uint8_t i = 0; i < Size; i++ ) {
-        MessageOutput[0]++;
-        if( i > ( uint8_t ) 0 ) {
-            MessageOutput[i] = *( Data );
-        }
-    }
-
-    /*The function is used and its result is verified.*/
-    Status = HAL_FDCAN_AddMessageToTxFifoQ( &CANHandler, &CANTxHeader, MessageOutput );
-    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
-    assert_error( Status == HAL_OK, CAN_RET_ERROR );
-}
-
-/**
- * @brief   **Function to unpack the message recieved into the Fifo0 buffer.**
- *
- * This function saves the first element of the received string to define the size of the rest of the 
- * message, and in function of this number, saves into a new global array the rest of the elements.
- *
- * @param   <*Data[in]> Pointer to the adress of the variable that will contain the unpacked message.
- * @param   <*Size[in]> Pointer to the adress of the variable that will contain the single frame message size.
- * @param   <*Data[out]> Pointer to the adress of the variable that will contain the unpacked message.
- * @param   <*Size[out]> Pointer to the adress of the variable that will contain the single frame message size.
- *
- * @retval  A flag variable returns 1 if a certain number of bytes were received, otherwise a 0, 
- * when no message was received yet or the message is not complain with CAN-TP single frame format.
- */
-
-static uint8_t CanTp_SingleFrameRx( uint8_t *Data, uint8_t *Size ) {
-    uint8_t Flag;
-
-    if( Message == ( uint8_t ) 1 ) {
-        Message = 0;
-
-        *( Size ) = RxData[0];
-
-        for( uint8_t i = 0; i < ( uint8_t ) 7; i++) {
-            Data[i] = RxData[i + ( uint8_t ) 1];
-        }
-
-        if( ( *( Size ) < 1 ) || ( *( Size ) > 8 ) ) {
-            Flag = 0;
-        }
-        else {
-            Flag = 1;
-        }
-    }
-    else {
-        Flag = 0;
-    }
-
-    return Flag;
-}
\ No newline at end of file
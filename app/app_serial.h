@@ -7,8 +7,21 @@
 #define APP_SERIAL_H__
 
 #include "app_bsp.h"
+#include "app_cantp.h"
+
+/**
+ * @brief Structure with the counters of the CAN reception.
+*/
+typedef struct
+{
+    uint32_t    frames;         /**< Frames read from the Rx Fifo.                                    */
+    uint32_t    full;           /**< Times the Rx Fifo was found full.                                */
+    uint32_t    lost;           /**< Overruns, times a frame was lost with the Rx Fifo full.          */
+    uint32_t    errors;         /**< Frames the HAL failed to read.                                   */
+} SERIAL_RxStatsTypeDef;
 
 void Serial_Init( void );
 void Serial_Task( void );
+void Serial_GetRxStats( SERIAL_RxStatsTypeDef *stats );
 
 #endif
\ No newline at end of file
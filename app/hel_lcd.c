@@ -53,6 +53,18 @@ __weak void HEL_LCD_MspInit( LCD_HandleTypeDef *hlcd ){
 }
 
 uint8_t HEL_LCD_Init( LCD_HandleTypeDef *hlcd ){
+    Coroutine_TypeDef Init = {0};
+
+    /*The same sequence of the coroutine, waiting here for every delay.*/
+    while( HEL_LCD_InitAsync( hlcd, &Init ) == ( uint8_t ) COROUTINE_RUNNING ) {
+    }
+
+    return ( uint8_t ) Init.Status;
+}
+
+uint8_t HEL_LCD_InitAsync( LCD_HandleTypeDef *hlcd, Coroutine_TypeDef *co ){
+    COROUTINE_BEGIN( co );
+
     assert_error( (hlcd->CSPort == GPIOD), LCD_PAR_ERROR );      /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
     assert_error( (hlcd->RSTPort == GPIOD), LCD_PAR_ERROR );     /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
     assert_error( (hlcd->RSPort == GPIOD), LCD_PAR_ERROR );      /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
@@ -63,32 +75,33 @@ uint8_t HEL_LCD_Init( LCD_HandleTypeDef *hlcd ){
     assert_error( (hlcd->BKLPin == GPIO_PIN_4), LCD_PAR_ERROR ); /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
     assert_error( (hlcd->SPIHandler != NULL), LCD_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
 
-    uint8_t resulInit = 0;
+    co->Status = 0;
     HEL_LCD_MspInit( hlcd );
 
     //CS = 1;
     HAL_GPIO_WritePin(hlcd->CSPort, hlcd->CSPin, SET);
     //RST = 0;
     HAL_GPIO_WritePin(hlcd->RSTPort, hlcd->RSTPin, RESET);
-    HAL_Delay( 2 );
+    COROUTINE_WAIT_MS( co, 2u );
     //RST = 1;
     HAL_GPIO_WritePin(hlcd->RSTPort, hlcd->RSTPin, SET);
-    HAL_Delay( 20 );
-    resulInit = HEL_LCD_Command( hlcd, 0x30 ); /*Wakeup.*/
-    HAL_Delay( 2 );
-    resulInit = HEL_LCD_Command( hlcd, 0x30 ); /*Wakeup.*/
-    resulInit = HEL_LCD_Command( hlcd, 0x30 ); /*Wakeup.*/
-    resulInit = HEL_LCD_Command( hlcd, 0x39 ); /*Function set.*/
-    resulInit = HEL_LCD_Command( hlcd, 0x14 ); /*Internal osc frequency.*/
-    resulInit = HEL_LCD_Command( hlcd, 0x56 ); /*Power controll.*/
-    resulInit = HEL_LCD_Command( hlcd, 0x6d ); /*Follower control.*/
-    HAL_Delay( 200 );
-    resulInit = HEL_LCD_Command( hlcd, 0x70 ); /*Constrast.*/
-    resulInit = HEL_LCD_Command( hlcd, 0x0C ); /*Display on.*/
-    resulInit = HEL_LCD_Command( hlcd, 0x06 ); /*Entry mode.*/
-    resulInit = HEL_LCD_Command( hlcd, 0x01 ); /*Clear screen.*/
-    HAL_Delay( 1 );
-    return resulInit;
+    COROUTINE_WAIT_MS( co, 20u );
+    co->Status |= HEL_LCD_Command( hlcd, 0x30 ); /*Wakeup.*/
+    COROUTINE_WAIT_MS( co, 2u );
+    co->Status |= HEL_LCD_Command( hlcd, 0x30 ); /*Wakeup.*/
+    co->Status |= HEL_LCD_Command( hlcd, 0x30 ); /*Wakeup.*/
+    co->Status |= HEL_LCD_Command( hlcd, 0x39 ); /*Function set.*/
+    co->Status |= HEL_LCD_Command( hlcd, 0x14 ); /*Internal osc frequency.*/
+    co->Status |= HEL_LCD_Command( hlcd, 0x56 ); /*Power controll.*/
+    co->Status |= HEL_LCD_Command( hlcd, 0x6d ); /*Follower control.*/
+    COROUTINE_WAIT_MS( co, 200u );
+    co->Status |= HEL_LCD_Command( hlcd, 0x70 ); /*Constrast.*/
+    co->Status |= HEL_LCD_Command( hlcd, 0x0C ); /*Display on.*/
+    co->Status |= HEL_LCD_Command( hlcd, 0x06 ); /*Entry mode.*/
+    co->Status |= HEL_LCD_Command( hlcd, 0x01 ); /*Clear screen.*/
+    COROUTINE_WAIT_MS( co, 1u );
+
+    COROUTINE_END( co );
 }
 
 uint8_t HEL_LCD_Command( LCD_HandleTypeDef *hlcd, uint8_t cmd ){
@@ -7,6 +7,7 @@
 #define HEL_LCD_H
 
 #include "app_bsp.h"
+#include "hil_coroutine.h"
 
 /**
   * @brief  Structure that contains the variables that will be used by the LCD and SPI module.
@@ -29,6 +30,13 @@ typedef struct {
 
 uint8_t HEL_LCD_Init( LCD_HandleTypeDef *hlcd );
 
+/**
+ * @brief Function to initialice the LCD as a coroutine, it returns COROUTINE_RUNNING on every delay
+ * and COROUTINE_DONE once the LCD is ready, the command results are ORed in co->Status.
+*/
+
+uint8_t HEL_LCD_InitAsync( LCD_HandleTypeDef *hlcd, Coroutine_TypeDef *co );
+
 /**
  * @brief Function to transmit the commands to LCD.
 */
@@ -0,0 +1,86 @@
+/**
+ * @file    hil_coroutine.h
+ * @brief   **This file contains the macros to write tasks as coroutines.**
+ *
+ * A coroutine is a function called once per task execution that returns when it has to wait and
+ * continues from the same point on the next call, so a long sequence shares the CPU with the rest of
+ * the tasks instead of blocking them. The body goes between COROUTINE_BEGIN and COROUTINE_END, and
+ * the resume point is saved as the line number of the last wait (a switch jumps back to it).
+ *
+ * Local variables are not kept between calls, what must survive a wait has to be static or part of
+ * the structure that holds the coroutine. No switch statement can enclose a wait inside the body.
+ */
+
+#ifndef HIL_COROUTINE_H
+#define HIL_COROUTINE_H
+
+    #include "app_bsp.h"
+
+    /**
+     * @defgroup <Values returned by a coroutine.>
+     *
+     @{ */
+    #define     COROUTINE_RUNNING   0   /*!< The coroutine is waiting and has to be called again.*/
+    #define     COROUTINE_DONE      1   /*!< The coroutine reached its end, next call starts over.*/
+    /**
+     @} */
+
+    /**
+     * @brief Structure with the state of a coroutine, it must be zero before the first call.
+    */
+    typedef struct
+    {
+        uint32_t    Line;           /**< Line of the wait to resume from, 0 to start from the beginning.  */
+        uint32_t    TickStart;      /**< Tick when the current delay started.                             */
+        uint32_t    Delay;          /**< Time in ms of the current delay.                                 */
+        uint32_t    Status;         /**< Free for the body to keep a result across the waits.             */
+    } Coroutine_TypeDef;
+
+    /**
+     * @brief   Sets a coroutine to start from the beginning on the next call.
+     */
+    #define COROUTINE_INIT( co )                ( co )->Line = 0u
+
+    /**
+     * @brief   Opens the body of the coroutine, jumping to the point where it returned the last time.
+     */
+    /*cppcheck-suppress misra-c2012-20.10 ; The resume points are case labels of this switch.*/
+    #define COROUTINE_BEGIN( co )               switch( ( co )->Line ) { case 0u:
+
+    /**
+     * @brief   Returns and continues after this point on the next call.
+     */
+    #define COROUTINE_YIELD( co )                                                   \
+        do {                                                                        \
+            ( co )->Line = ( uint32_t ) __LINE__;                                   \
+            return COROUTINE_RUNNING;                                               \
+            case __LINE__: ;                                                        \
+        } while( 0 )
+
+    /**
+     * @brief   Returns until the condition is true, it is evaluated again on every call.
+     */
+    #define COROUTINE_WAIT_UNTIL( co, cond )                                        \
+        do {                                                                        \
+            ( co )->Line = ( uint32_t ) __LINE__;                                   \
+            case __LINE__:                                                          \
+            if( !( cond ) ) { return COROUTINE_RUNNING; }                           \
+        } while( 0 )
+
+    /**
+     * @brief   Returns until at least ms milliseconds have passed, the delay is measured with the HAL
+     * tick and is only checked when the coroutine is called, so it ends on the next call after it.
+     */
+    #define COROUTINE_WAIT_MS( co, ms )                                             \
+        do {                                                                        \
+            ( co )->TickStart = HAL_GetTick();                                      \
+            ( co )->Delay = ( ms );                                                 \
+            COROUTINE_WAIT_UNTIL( ( co ), ( HAL_GetTick() - ( co )->TickStart ) >= ( co )->Delay ); \
+        } while( 0 )
+
+    /**
+     * @brief   Closes the body of the coroutine, the next call starts from the beginning again.
+     */
+    #define COROUTINE_END( co )                 } ( co )->Line = 0u; return COROUTINE_DONE
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file    hil_pool.c
+ * @brief   **This file has the functions of the fixed-block memory pool.**
+ *
+ */
+
+#include "app_bsp.h"
+
+/**
+ * @brief   Initializes the pool linking all of its blocks in the free list
+ *
+ * The fields Buffer, Blocks and Size must be set before, the size has to hold a pointer and keep the
+ * blocks aligned to it.
+ * @param   hpool Pool Handler
+ */
+void HIL_POOL_Init( POOL_HandleTypeDef *hpool )
+{
+    uint8_t *Block = ( uint8_t * ) hpool->Buffer;
+
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( hpool->Buffer != NULL, POOL_PAR_ERROR );
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( hpool->Blocks != 0u, POOL_PAR_ERROR );
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( ( hpool->Size >= sizeof( void * ) ) && ( ( hpool->Size % sizeof( void * ) ) == 0u ), POOL_PAR_ERROR );
+
+    for( uint32_t i = 0; i < ( hpool->Blocks - 1u ); i++ )
+    {
+        /*cppcheck-suppress misra-c2012-11.3 ; The first word of a free block is the link to the next one.*/
+        *( void ** ) Block = &Block[ hpool->Size ];
+        Block = &Block[ hpool->Size ];
+    }
+    /*cppcheck-suppress misra-c2012-11.3 ; The first word of a free block is the link to the next one.*/
+    *( void ** ) Block = NULL;
+
+    hpool->FreeList = hpool->Buffer;
+    ( void ) memset( &hpool->Stats, 0, sizeof( POOL_StatsTypeDef ) );
+}
+
+/**
+ * @brief   Takes a block from the pool
+ *
+ * The block keeps what was written on it the last time it was used.
+ * @param   hpool Pool Handler
+ * @retval  Pointer to the block, NULL if there are no free blocks
+ */
+void *HIL_POOL_Alloc( POOL_HandleTypeDef *hpool )
+{
+    void *Block = hpool->FreeList;
+
+    if( Block == NULL )
+    {
+        hpool->Stats.fails++;
+    }
+    else
+    {
+        hpool->FreeList = *( void ** ) Block;
+        hpool->Stats.used++;
+        if( hpool->Stats.used > hpool->Stats.peak )
+        {
+            hpool->Stats.peak = hpool->Stats.used;
+        }
+    }
+
+    return Block;
+}
+
+/**
+ * @brief   Gives a block back to the pool
+ *
+ * The block must have been taken from the same pool, a pointer out of the buffer or not at the start
+ * of a block goes to the safe state.
+ * @param   hpool Pool Handler
+ * @param   block Block to give back
+ */
+void HIL_POOL_Free( POOL_HandleTypeDef *hpool, void *block )
+{
+    uintptr_t Offset = ( uintptr_t ) block - ( uintptr_t ) hpool->Buffer;
+
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( ( ( uintptr_t ) block >= ( uintptr_t ) hpool->Buffer ) && ( Offset < ( hpool->Blocks * hpool->Size ) ), POOL_PAR_ERROR );
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( ( Offset % hpool->Size ) == 0u, POOL_PAR_ERROR );
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( hpool->Stats.used != 0u, POOL_PAR_ERROR );
+
+    *( void ** ) block = hpool->FreeList;
+    hpool->FreeList = block;
+    hpool->Stats.used--;
+}
+
+/**
+ * @brief   Takes a block from the pool with the interrupt isr masked
+ * @param   hpool Pool Handler
+ * @param   isr Interrupt to mask, 0xFF masks all of them
+ * @retval  Pointer to the block, NULL if there are no free blocks
+ */
+void *HIL_POOL_AllocISR( POOL_HandleTypeDef *hpool, uint8_t isr )
+{
+    void *Block;
+
+    HIL_QUEUE_Lock( isr );
+    Block = HIL_POOL_Alloc( hpool );
+    HIL_QUEUE_Unlock( isr );
+
+    return Block;
+}
+
+/**
+ * @brief   Gives a block back to the pool with the interrupt isr masked
+ * @param   hpool Pool Handler
+ * @param   block Block to give back
+ * @param   isr Interrupt to mask, 0xFF masks all of them
+ */
+void HIL_POOL_FreeISR( POOL_HandleTypeDef *hpool, void *block, uint8_t isr )
+{
+    HIL_QUEUE_Lock( isr );
+    HIL_POOL_Free( hpool, block );
+    HIL_QUEUE_Unlock( isr );
+}
+
+/**
+ * @brief   Copies the usage statistics of the pool
+ * @param   hpool Pool Handler
+ * @param   stats Structure where the statistics are copied
+ */
+void HIL_POOL_GetStats( POOL_HandleTypeDef *hpool, POOL_StatsTypeDef *stats )
+{
+    *stats = hpool->Stats;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file    hil_pool.h
+ * @brief   **This file declares the functions and variables of the fixed-block memory pool.**
+ *
+ * A pool hands out blocks of the same size from a buffer reserved at build time, the free blocks are
+ * kept in a list linked through their first word so taking or giving back a block does not depend on
+ * the number of blocks. The messages are allocated from a pool and only their pointers go through the
+ * queues, the block belongs to whoever holds the pointer and the last one gives it back.
+ */
+
+#ifndef HIL_POOL_H
+#define HIL_POOL_H
+
+    #include "app_bsp.h"
+
+    /**
+     * @brief Structure with the usage statistics of a pool.
+    */
+    typedef struct
+    {
+        uint32_t    used;           /**< Blocks allocated at this moment.                                 */
+        uint32_t    peak;           /**< Most blocks allocated at the same time.                          */
+        uint32_t    fails;          /**< Allocations refused because there were no free blocks.           */
+    } POOL_StatsTypeDef;
+
+    /**
+     * @brief Structure with the elements of the pool.
+    */
+    typedef struct
+    {
+        void        *Buffer;        /**< Pointer to the memory space split in blocks.                     */
+        uint32_t    Blocks;         /**< Number of blocks of the buffer.                                  */
+        uint32_t    Size;           /**< Size in bytes of every block, at least the size of a pointer.   */
+        void        *FreeList;      /**< First free block, every free block points to the next one.      */
+        POOL_StatsTypeDef Stats;    /**< Usage statistics. */
+    } POOL_HandleTypeDef;
+
+    /**
+     * @brief   Initializes the pool linking all of its blocks in the free list
+     */
+    void HIL_POOL_Init( POOL_HandleTypeDef *hpool );
+
+    /**
+     * @brief   Takes a block from the pool, returns NULL if there are no free blocks
+     */
+    void *HIL_POOL_Alloc( POOL_HandleTypeDef *hpool );
+
+    /**
+     * @brief   Gives a block back to the pool
+     */
+    void HIL_POOL_Free( POOL_HandleTypeDef *hpool, void *block );
+
+    /**
+     * @brief   Takes a block from the pool with the interrupt isr masked, or all of them with 0xFF
+     */
+    void *HIL_POOL_AllocISR( POOL_HandleTypeDef *hpool, uint8_t isr );
+
+    /**
+     * @brief   Gives a block back to the pool with the interrupt isr masked, or all of them with 0xFF
+     */
+    void HIL_POOL_FreeISR( POOL_HandleTypeDef *hpool, void *block, uint8_t isr );
+
+    /**
+     * @brief   Copies the usage statistics of the pool
+     */
+    void HIL_POOL_GetStats( POOL_HandleTypeDef *hpool, POOL_StatsTypeDef *stats );
+
+#endif
@@ -4,7 +4,7 @@
  * 
  */
 
-#include "hil_queue.h"
+#include "app_bsp.h"
 
 /**
  * @brief   The function returns a one if the queue is full, 0 otherwise
@@ -22,6 +22,7 @@ void HIL_QUEUE_Init( QUEUE_HandleTypeDef *hqueue )
     hqueue->Full          = 0;
     hqueue->Empty         = 1;
     hqueue->SavedElements = 0;
+    ( void ) memset( &hqueue->Stats, 0, sizeof( QUEUE_StatsTypeDef ) );
 }
 
 
@@ -36,6 +37,7 @@ uint8_t HIL_QUEUE_Write( QUEUE_HandleTypeDef *hqueue, void *data )
 
     if( HIL_QUEUE_IsFull( hqueue ) == ( uint8_t ) 1 ){
         hqueue->Full = 1;
+        hqueue->Stats.drops++;
         valueToReturn = QUEUE_NOT_OK;
     }
 
@@ -44,6 +46,7 @@ uint8_t HIL_QUEUE_Write( QUEUE_HandleTypeDef *hqueue, void *data )
         ( void ) memcpy( hqueue->Buffer + ( hqueue->Size * hqueue->Tail ), data, hqueue->Size );
         hqueue->Tail = (hqueue->Tail + ( uint32_t ) 1) % hqueue->Elements;
         hqueue->SavedElements++;
+        HIL_QUEUE_WriteStats( &hqueue->Stats, 1u, hqueue->SavedElements );
         
         valueToReturn = QUEUE_OK;
 
@@ -56,6 +59,28 @@ uint8_t HIL_QUEUE_Write( QUEUE_HandleTypeDef *hqueue, void *data )
 }
 
 
+/**
+ * @brief   Copies data to the queue, with the queue full the oldest element is discarded to make room
+ *
+ * For producers that publish a state, the reader gets the most recent elements instead of a backlog of
+ * old ones, the discarded elements are counted as drops.
+ *
+ * @param   hqueue Queue Handler
+ * @param   data Variable where data will be copied
+ */
+void HIL_QUEUE_Overwrite( QUEUE_HandleTypeDef *hqueue, void *data )
+{
+    if( HIL_QUEUE_IsFull( hqueue ) == ( uint8_t ) 1 )
+    {
+        hqueue->Head = ( hqueue->Head + ( uint32_t ) 1 ) % hqueue->Elements;
+        hqueue->SavedElements--;
+        hqueue->Stats.drops++;
+    }
+
+    ( void ) HIL_QUEUE_Write( hqueue, data );
+}
+
+
 /**
  * @brief   Reads data from the buffer controlled by hqueue, the data is copied into the data type referenced by the empty pointer data
  * @param   hqueue Queue Handler
@@ -75,6 +100,7 @@ uint8_t HIL_QUEUE_Read( QUEUE_HandleTypeDef *hqueue, void *data )
         ( void ) memcpy(data, hqueue->Buffer + (hqueue->Size * hqueue->Head), hqueue->Size);
         hqueue->Head = ( hqueue->Head + ( uint32_t ) 1 ) % hqueue->Elements;
         hqueue->SavedElements--;
+        hqueue->Stats.reads++;
 
         valueToReturn = QUEUE_OK;
 
@@ -97,6 +123,103 @@ uint8_t HIL_QUEUE_IsEmpty( QUEUE_HandleTypeDef *hqueue )
 }
 
 
+/**
+ * @brief   Copies up to n elements from the array data to the queue, returns the number of elements written
+ *
+ * The elements that fit are copied with at most two copies, up to the end of the buffer and from its
+ * beginning, the Full flag is set when not all of them fit.
+ *
+ * @param   hqueue Queue Handler
+ * @param   data Array with the elements to write
+ * @param   n Number of elements in the array
+ * @retval  The number of elements written.
+ */
+uint32_t HIL_QUEUE_WriteN( QUEUE_HandleTypeDef *hqueue, void *data, uint32_t n )
+{
+    uint32_t Count = hqueue->Elements - hqueue->SavedElements;
+    uint32_t First;
+
+    if( n < Count )
+    {
+        Count = n;
+    }
+
+    First = hqueue->Elements - hqueue->Tail;
+    if( Count < First )
+    {
+        First = Count;
+    }
+
+    /* cppcheck-suppress misra-c2012-18.4 ; Operation needed for correct functioning. */
+    ( void ) memcpy( ( uint8_t * ) hqueue->Buffer + ( hqueue->Size * hqueue->Tail ), data, hqueue->Size * First );
+    if( Count > First )
+    {
+        /* cppcheck-suppress misra-c2012-18.4 ; Operation needed for correct functioning. */
+        ( void ) memcpy( hqueue->Buffer, ( uint8_t * ) data + ( hqueue->Size * First ), hqueue->Size * ( Count - First ) );
+    }
+
+    hqueue->Tail = ( hqueue->Tail + Count ) % hqueue->Elements;
+    hqueue->SavedElements += Count;
+    HIL_QUEUE_WriteStats( &hqueue->Stats, Count, hqueue->SavedElements );
+
+    if( Count < n )
+    {
+        hqueue->Full = 1;
+        hqueue->Stats.drops += n - Count;
+    }
+
+    return Count;
+}
+
+
+/**
+ * @brief   Reads up to n elements from the queue to the array data, returns the number of elements read
+ *
+ * The elements saved are copied with at most two copies, up to the end of the buffer and from its
+ * beginning, the Empty flag is set when there were less than n.
+ *
+ * @param   hqueue Queue Handler
+ * @param   data Array where the elements will be copied
+ * @param   n Number of elements the array can hold
+ * @retval  The number of elements read.
+ */
+uint32_t HIL_QUEUE_ReadN( QUEUE_HandleTypeDef *hqueue, void *data, uint32_t n )
+{
+    uint32_t Count = hqueue->SavedElements;
+    uint32_t First;
+
+    if( n < Count )
+    {
+        Count = n;
+    }
+
+    First = hqueue->Elements - hqueue->Head;
+    if( Count < First )
+    {
+        First = Count;
+    }
+
+    /* cppcheck-suppress misra-c2012-18.4 ; Operation needed for correct functioning. */
+    ( void ) memcpy( data, ( uint8_t * ) hqueue->Buffer + ( hqueue->Size * hqueue->Head ), hqueue->Size * First );
+    if( Count > First )
+    {
+        /* cppcheck-suppress misra-c2012-18.4 ; Operation needed for correct functioning. */
+        ( void ) memcpy( ( uint8_t * ) data + ( hqueue->Size * First ), hqueue->Buffer, hqueue->Size * ( Count - First ) );
+    }
+
+    hqueue->Head = ( hqueue->Head + Count ) % hqueue->Elements;
+    hqueue->SavedElements -= Count;
+    hqueue->Stats.reads += Count;
+
+    if( Count < n )
+    {
+        hqueue->Empty = 1;
+    }
+
+    return Count;
+}
+
+
 /**
  * @brief   The function must empty the queue in case it has elements inside it, the information will be discarded
  * @param   hqueue Queue handler 
@@ -154,6 +277,32 @@ uint8_t HIL_QUEUE_WriteISR( QUEUE_HandleTypeDef *hqueue, void *data, uint8_t isr
     return valueToReturn;
 }
 
+/**
+ * @brief   Copies data to the queue discarding the oldest element when it is full and operates with interrupt
+ * @param   hqueue Queue Handler
+ * @param   data Variable where data will be copied
+ * @param   isr Interrupt ID that will be disabled
+ */
+void HIL_QUEUE_OverwriteISR( QUEUE_HandleTypeDef *hqueue, void *data, uint8_t isr )
+{
+    if( isr == ( uint8_t ) 0xFF )                       //Enable/disable all interrupt
+    {
+        __disable_irq();
+        HIL_QUEUE_Overwrite( hqueue, data );
+        __enable_irq();
+    }
+
+    else
+    {
+        if( isr <= ( uint8_t ) 30 )                     //Validate that isr is a member of IRQn_Type enum
+        {  
+            HAL_NVIC_DisableIRQ( isr );
+            HIL_QUEUE_Overwrite( hqueue, data );
+            HAL_NVIC_EnableIRQ( isr );
+        }
+    }
+}
+
 /**
  * @brief   Reads data from the buffer controlled by hqueue, the data is copied into the data type referenced by the empty pointer data  and operates with interrupt
  * @param   hqueue Queue Handler
@@ -222,6 +371,70 @@ uint8_t HIL_QUEUE_IsEmptyISR( QUEUE_HandleTypeDef *hqueue, uint8_t isr )
     return valueToReturn;
 }
 
+/**
+ * @brief   Copies up to n elements from the array data to the queue in a single critical section
+ * @param   hqueue Queue Handler
+ * @param   data Array with the elements to write
+ * @param   n Number of elements in the array
+ * @param   isr Interrupt ID that will be disabled
+ * @retval  The number of elements written.
+ */
+uint32_t HIL_QUEUE_WriteNISR( QUEUE_HandleTypeDef *hqueue, void *data, uint32_t n, uint8_t isr )
+{
+    uint32_t valueToReturn = 0;
+
+    if( isr == ( uint8_t ) 0xFF )                       //Enable/disable all interrupt
+    {
+        __disable_irq();
+        valueToReturn = HIL_QUEUE_WriteN( hqueue, data, n );
+        __enable_irq();
+    }
+
+    else
+    {
+        if( isr <= ( uint8_t ) 30 )                     //Validate that isr is a member of IRQn_Type enum
+        {  
+            HAL_NVIC_DisableIRQ( isr );
+            valueToReturn = HIL_QUEUE_WriteN( hqueue, data, n );
+            HAL_NVIC_EnableIRQ( isr );
+        }
+    }
+    
+    return valueToReturn;
+}
+
+/**
+ * @brief   Reads up to n elements from the queue to the array data in a single critical section
+ * @param   hqueue Queue Handler
+ * @param   data Array where the elements will be copied
+ * @param   n Number of elements the array can hold
+ * @param   isr Interrupt ID that will be disabled
+ * @retval  The number of elements read.
+ */
+uint32_t HIL_QUEUE_ReadNISR( QUEUE_HandleTypeDef *hqueue, void *data, uint32_t n, uint8_t isr )
+{
+    uint32_t valueToReturn = 0;
+
+    if( isr == ( uint8_t ) 0xFF )                       //Enable/disable all interrupt
+    {
+        __disable_irq();
+        valueToReturn = HIL_QUEUE_ReadN( hqueue, data, n );
+        __enable_irq();
+    }
+
+    else
+    {
+        if( isr <= ( uint8_t ) 30 )                     //Validate that isr is a member of IRQn_Type enum
+        {  
+            HAL_NVIC_DisableIRQ( isr );
+            valueToReturn = HIL_QUEUE_ReadN( hqueue, data, n );
+            HAL_NVIC_EnableIRQ( isr );
+        }
+    }
+    
+    return valueToReturn;
+}
+
 /**
  * @brief   The function must empty the queue in case it has elements inside it, the information will be discarded and operates wih interrupt
  */
@@ -246,4 +459,204 @@ void HIL_QUEUE_FlushISR( QUEUE_HandleTypeDef *hqueue, uint8_t isr )
         }
     }
     
-}
\ No newline at end of file
+}
+
+/**
+ * @brief   Initializes a queue with a power of two number of elements to be used with the SPSC functions
+ *
+ * With a single writer and a single reader, like an interrupt and a task, each side only changes its
+ * own index, so no interrupt needs to be masked. The indexes run freely and wrap over the buffer with
+ * a mask, their difference is the number of saved elements. The queue must not be mixed with the rest
+ * of the functions.
+ *
+ * @param   hqueue Queue Handler
+ */
+void HIL_QUEUE_InitSPSC( QUEUE_HandleTypeDef *hqueue )
+{
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( ( hqueue->Elements != 0u ) && ( ( hqueue->Elements & ( hqueue->Elements - 1u ) ) == 0u ), QUEUE_PAR_ERROR );
+
+    HIL_QUEUE_Init( hqueue );
+}
+
+/**
+ * @brief   Copies the information referenced by data to the queue without masking interrupts, for the only writer of the queue
+ * @param   hqueue Queue Handler
+ * @param   data Variable where data will be copied
+ */
+uint8_t HIL_QUEUE_WriteSPSC( QUEUE_HandleTypeDef *hqueue, void *data )
+{
+    uint8_t valueToReturn = QUEUE_NOT_OK;
+    void *Slot = HIL_QUEUE_Reserve( hqueue );
+
+    if( Slot != NULL )
+    {
+        ( void ) memcpy( Slot, data, hqueue->Size );
+        HIL_QUEUE_Commit( hqueue );
+
+        valueToReturn = QUEUE_OK;
+    }
+
+    return valueToReturn;
+}
+
+/**
+ * @brief   Reads data from the queue without masking interrupts, for the only reader of the queue
+ * @param   hqueue Queue Handler
+ * @param   data Variable where data will be copied
+ */
+uint8_t HIL_QUEUE_ReadSPSC( QUEUE_HandleTypeDef *hqueue, void *data )
+{
+    uint8_t valueToReturn = QUEUE_NOT_OK;
+    void *Slot = HIL_QUEUE_Peek( hqueue );
+
+    if( Slot != NULL )
+    {
+        ( void ) memcpy( data, Slot, hqueue->Size );
+        HIL_QUEUE_Release( hqueue );
+
+        valueToReturn = QUEUE_OK;
+    }
+
+    return valueToReturn;
+}
+
+/**
+ * @brief   The function returns a one if there are no elements to read, without masking interrupts
+ * @param   hqueue Queue Handler
+ */
+uint8_t HIL_QUEUE_IsEmptySPSC( QUEUE_HandleTypeDef *hqueue )
+{
+    return ( hqueue->Tail == hqueue->Head );
+}
+
+/**
+ * @brief   Returns the space of the next element to write, for the only writer of a SPSC queue
+ *
+ * The writer fills the element in place and makes it visible to the reader with HIL_QUEUE_Commit,
+ * the space is not taken until then, so reserving again returns the same space.
+ *
+ * @param   hqueue Queue Handler
+ * @retval  Pointer to the space of the element, or NULL if the queue is full.
+ */
+void *HIL_QUEUE_Reserve( QUEUE_HandleTypeDef *hqueue )
+{
+    void *Slot = NULL;
+    uint32_t Tail = hqueue->Tail;
+
+    if( ( Tail - hqueue->Head ) < hqueue->Elements )
+    {
+        /* cppcheck-suppress misra-c2012-18.4 ; Operation needed for correct functioning. */
+        Slot = ( uint8_t * ) hqueue->Buffer + ( hqueue->Size * ( Tail & ( hqueue->Elements - 1u ) ) );
+    }
+    else
+    {
+        /*The writer has nowhere to put the element, it is counted as dropped.*/
+        hqueue->Stats.drops++;
+    }
+
+    return Slot;
+}
+
+/**
+ * @brief   Saves the element written in the space returned by HIL_QUEUE_Reserve
+ * @param   hqueue Queue Handler
+ */
+void HIL_QUEUE_Commit( QUEUE_HandleTypeDef *hqueue )
+{
+    /*The element is in memory before the reader can see it.*/
+    __DMB();
+    hqueue->Tail = hqueue->Tail + 1u;
+    /*Only the writer updates the peak, the reader can only make the queue shorter meanwhile.*/
+    HIL_QUEUE_WriteStats( &hqueue->Stats, 1u, hqueue->Tail - hqueue->Head );
+}
+
+/**
+ * @brief   Returns the next element to read without taking it out, for the only reader of a SPSC queue
+ *
+ * The reader uses the element in place and frees its space with HIL_QUEUE_Release, the writer does
+ * not touch it until then.
+ *
+ * @param   hqueue Queue Handler
+ * @retval  Pointer to the element, or NULL if the queue is empty.
+ */
+void *HIL_QUEUE_Peek( QUEUE_HandleTypeDef *hqueue )
+{
+    void *Slot = NULL;
+    uint32_t Head = hqueue->Head;
+
+    if( hqueue->Tail != Head )
+    {
+        /* cppcheck-suppress misra-c2012-18.4 ; Operation needed for correct functioning. */
+        Slot = ( uint8_t * ) hqueue->Buffer + ( hqueue->Size * ( Head & ( hqueue->Elements - 1u ) ) );
+    }
+
+    return Slot;
+}
+
+/**
+ * @brief   Takes out of the queue the element returned by HIL_QUEUE_Peek
+ * @param   hqueue Queue Handler
+ */
+void HIL_QUEUE_Release( QUEUE_HandleTypeDef *hqueue )
+{
+    /*The element is no longer used before the writer can reuse its space.*/
+    __DMB();
+    hqueue->Head = hqueue->Head + 1u;
+    hqueue->Stats.reads++;
+}
+
+/**
+ * @brief   Copies the traffic statistics of the queue
+ *
+ * The counters run since HIL_QUEUE_Init, the peak is the most elements saved at the same time and
+ * tells how much of the buffer is really needed, the drops are the elements not written because the
+ * queue was full. The counters are read without masking interrupts, so with an interrupt writing they
+ * may be one operation apart from each other.
+ *
+ * @param   hqueue Queue Handler
+ * @param   stats Structure where the statistics will be copied
+ */
+void HIL_QUEUE_GetStats( QUEUE_HandleTypeDef *hqueue, QUEUE_StatsTypeDef *stats )
+{
+    *stats = hqueue->Stats;
+}
+
+/**
+ * @brief   Masks the interrupt isr, or all of them with 0xFF, around the typed queue ISR functions
+ *
+ * Like the ISR functions of the generic queue the isr has to be a member of IRQn_Type from 0 to 30,
+ * any other value goes to the safe state instead of running without the lock.
+ * @param   isr Interrupt to mask
+ */
+void HIL_QUEUE_Lock( uint8_t isr )
+{
+    if( isr == ( uint8_t ) 0xFF )
+    {
+        __disable_irq();
+    }
+    else
+    {
+        /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+        assert_error( isr <= ( uint8_t ) 30, QUEUE_PAR_ERROR );
+        HAL_NVIC_DisableIRQ( ( IRQn_Type ) isr );
+    }
+}
+
+/**
+ * @brief   Unmasks the interrupt masked by HIL_QUEUE_Lock
+ * @param   isr Interrupt to unmask, 0xFF unmasks all of them
+ */
+void HIL_QUEUE_Unlock( uint8_t isr )
+{
+    if( isr == ( uint8_t ) 0xFF )
+    {
+        __enable_irq();
+    }
+    else
+    {
+        /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+        assert_error( isr <= ( uint8_t ) 30, QUEUE_PAR_ERROR );
+        HAL_NVIC_EnableIRQ( ( IRQn_Type ) isr );
+    }
+}
@@ -15,10 +15,21 @@
      @{ */
     #define     QUEUE_OK            0   /*!< Queue worked correctly.*/
     #define     QUEUE_NOT_OK        1   /*!< Queue didn't work correctly.*/
-    #define     QUEUE_ELEMENTS      9   /*!< Number of possible messages to save in determined timing.*/
+    #define     QUEUE_ELEMENTS      16  /*!< Number of possible messages to save in determined timing, a power of two for the SPSC functions.*/
     /**
      @} */
 
+    /**
+     * @brief Structure with the traffic statistics of a queue.
+    */
+    typedef struct
+    {
+        uint32_t    writes;         /**< Elements written since the queue was initialized.                */
+        uint32_t    reads;          /**< Elements read since the queue was initialized.                   */
+        uint32_t    drops;          /**< Elements not written because the queue was full.                 */
+        uint32_t    peak;           /**< Most elements saved at the same time.                            */
+    } QUEUE_StatsTypeDef;
+
     /**
      * @brief Structure with the elements of the circular buffer.
     */
@@ -27,11 +38,12 @@
         void        *Buffer;        /**< Pointer to the memory space used as buffer by the queue.        */
         uint32_t    Elements;       /**< Number of elements to store (queue size).                */
         uint8_t     Size;           /**< Size of the type of elements to store.                           */
-        uint32_t    Head;           /**< Pointer indicating the next space to write.                 */
-        uint32_t    Tail;           /**< Pointer indicating the next space to read.                     */
+        volatile uint32_t Head;     /**< Pointer indicating the next space to read, only the reader changes it with the SPSC functions.  */
+        volatile uint32_t Tail;     /**< Pointer indicating the next space to write, only the writer changes it with the SPSC functions. */
         uint8_t     Empty;          /**< Flag that indicates if there are no elements to read.                      */
         uint8_t     Full;           /**< Flag that indicates if it is not possible to continue writing more elements. */
         uint32_t    SavedElements;   /**< Saved elements. */
+        QUEUE_StatsTypeDef Stats;   /**< Traffic statistics. */
     } QUEUE_HandleTypeDef;
 
     /**
@@ -49,11 +61,26 @@
      */
     uint8_t HIL_QUEUE_Read( QUEUE_HandleTypeDef *hqueue, void *data );
 
+    /**
+     * @brief   Copies data to the queue, with the queue full the oldest element is discarded to make room
+     */
+    void HIL_QUEUE_Overwrite( QUEUE_HandleTypeDef *hqueue, void *data );
+
     /**
      * @brief   The function returns a one if there are no more elements that can be read from the queue and zero if there is at least one element that can be read.
      */
     uint8_t HIL_QUEUE_IsEmpty( QUEUE_HandleTypeDef *hqueue );
 
+    /**
+     * @brief   Copies up to n elements from the array data to the queue, returns the number of elements written
+     */
+    uint32_t HIL_QUEUE_WriteN( QUEUE_HandleTypeDef *hqueue, void *data, uint32_t n );
+
+    /**
+     * @brief   Reads up to n elements from the queue to the array data, returns the number of elements read
+     */
+    uint32_t HIL_QUEUE_ReadN( QUEUE_HandleTypeDef *hqueue, void *data, uint32_t n );
+
     /**
      * @brief   The function must empty the queue in case it has elements inside it, the information will be discarded
      */
@@ -64,6 +91,11 @@
      */
     uint8_t HIL_QUEUE_WriteISR( QUEUE_HandleTypeDef *hqueue, void *data, uint8_t isr );
 
+    /**
+     * @brief   Copies data to the queue discarding the oldest element when it is full and operates with interrupt
+     */
+    void HIL_QUEUE_OverwriteISR( QUEUE_HandleTypeDef *hqueue, void *data, uint8_t isr );
+
     /**
      * @brief   Reads data from the buffer controlled by hqueue, the data is copied into the data type referenced by the empty pointer data  and operates with interrupt
      */
@@ -74,19 +106,223 @@
      */
     uint8_t HIL_QUEUE_IsEmptyISR( QUEUE_HandleTypeDef *hqueue, uint8_t isr );
 
+    /**
+     * @brief   Copies up to n elements from the array data to the queue in a single critical section
+     */
+    uint32_t HIL_QUEUE_WriteNISR( QUEUE_HandleTypeDef *hqueue, void *data, uint32_t n, uint8_t isr );
+
+    /**
+     * @brief   Reads up to n elements from the queue to the array data in a single critical section
+     */
+    uint32_t HIL_QUEUE_ReadNISR( QUEUE_HandleTypeDef *hqueue, void *data, uint32_t n, uint8_t isr );
+
     /**
      * @brief   The function must empty the queue in case it has elements inside it, the information will be discarded and operates wih interrupt
      */
     void HIL_QUEUE_FlushISR( QUEUE_HandleTypeDef *hqueue, uint8_t isr );
 
     /**
-     * @brief Struct variable of Queue elements to develop in clock
-    */
-    extern QUEUE_HandleTypeDef ClockQueue;
+     * @brief   Initializes a queue with a power of two number of elements to be used with the SPSC functions
+     */
+    void HIL_QUEUE_InitSPSC( QUEUE_HandleTypeDef *hqueue );
 
     /**
-     * @brief Struct variable of Queue elements to develop in DISPLAY
-    */
-    extern QUEUE_HandleTypeDef DisplayQueue;
-    
+     * @brief   Copies the information referenced by data to the queue without masking interrupts, for the only writer of the queue
+     */
+    uint8_t HIL_QUEUE_WriteSPSC( QUEUE_HandleTypeDef *hqueue, void *data );
+
+    /**
+     * @brief   Reads data from the queue without masking interrupts, for the only reader of the queue
+     */
+    uint8_t HIL_QUEUE_ReadSPSC( QUEUE_HandleTypeDef *hqueue, void *data );
+
+    /**
+     * @brief   The function returns a one if there are no elements to read, without masking interrupts
+     */
+    uint8_t HIL_QUEUE_IsEmptySPSC( QUEUE_HandleTypeDef *hqueue );
+
+    /**
+     * @brief   Returns the space of the next element to write in a SPSC queue, to fill it in place
+     */
+    void *HIL_QUEUE_Reserve( QUEUE_HandleTypeDef *hqueue );
+
+    /**
+     * @brief   Saves the element written in the space returned by HIL_QUEUE_Reserve
+     */
+    void HIL_QUEUE_Commit( QUEUE_HandleTypeDef *hqueue );
+
+    /**
+     * @brief   Returns the next element to read in a SPSC queue, to use it in place
+     */
+    void *HIL_QUEUE_Peek( QUEUE_HandleTypeDef *hqueue );
+
+    /**
+     * @brief   Takes out of the queue the element returned by HIL_QUEUE_Peek
+     */
+    void HIL_QUEUE_Release( QUEUE_HandleTypeDef *hqueue );
+
+    /**
+     * @brief   Copies the traffic statistics of the queue
+     */
+    void HIL_QUEUE_GetStats( QUEUE_HandleTypeDef *hqueue, QUEUE_StatsTypeDef *stats );
+
+    /**
+     * @brief   Counts n elements written and updates the peak with the elements saved after them
+     */
+    static inline void HIL_QUEUE_WriteStats( QUEUE_StatsTypeDef *stats, uint32_t n, uint32_t saved )
+    {
+        stats->writes += n;
+        if( saved > stats->peak )
+        {
+            stats->peak = saved;
+        }
+    }
+
+    /**
+     * @brief   Masks the interrupt isr, or all of them with 0xFF, around the typed queue ISR functions
+     */
+    void HIL_QUEUE_Lock( uint8_t isr );
+
+    /**
+     * @brief   Unmasks the interrupt masked by HIL_QUEUE_Lock
+     */
+    void HIL_QUEUE_Unlock( uint8_t isr );
+
+    /**
+     * @brief   Declares a queue of elements of the given type and capacity with its own functions.
+     *
+     * The buffer is part of the handle QUEUE_<name>_TypeDef, and the functions HIL_QUEUE_Init<name>,
+     * Write<name>, Overwrite<name>, Read<name>, ReadN<name>, IsEmpty<name>, GetStats<name> and the ISR
+     * versions of Write, Overwrite, Read and ReadN only take pointers to the type, so writing an element
+     * of another type does not build. A queue of one element written with Overwrite is a mailbox that
+     * always holds the latest value.
+     * The elements are copied by assignment with the size known at build time.
+     */
+    /*cppcheck-suppress misra-c2012-20.10 ; The names of the queue functions are built from the queue name.*/
+    #define HIL_QUEUE_TYPED( name, type, elements )                                                 \
+    typedef struct                                                                                  \
+    {                                                                                               \
+        type        Buffer[ elements ];                                                             \
+        uint32_t    Head;                                                                           \
+        uint32_t    Tail;                                                                           \
+        uint32_t    SavedElements;                                                                  \
+        uint8_t     Empty;                                                                          \
+        uint8_t     Full;                                                                           \
+        QUEUE_StatsTypeDef Stats;                                                                   \
+    } QUEUE_##name##_TypeDef;                                                                       \
+                                                                                                    \
+    static inline void HIL_QUEUE_Init##name( QUEUE_##name##_TypeDef *hqueue )                       \
+    {                                                                                               \
+        hqueue->Head          = 0;                                                                  \
+        hqueue->Tail          = 0;                                                                  \
+        hqueue->Full          = 0;                                                                  \
+        hqueue->Empty         = 1;                                                                  \
+        hqueue->SavedElements = 0;                                                                  \
+        ( void ) memset( &hqueue->Stats, 0, sizeof( QUEUE_StatsTypeDef ) );                         \
+    }                                                                                               \
+                                                                                                    \
+    static inline uint8_t HIL_QUEUE_Write##name( QUEUE_##name##_TypeDef *hqueue, const type *data ) \
+    {                                                                                               \
+        uint8_t valueToReturn = QUEUE_NOT_OK;                                                       \
+        if( hqueue->SavedElements == ( uint32_t ) ( elements ) )                                    \
+        {                                                                                           \
+            hqueue->Full = 1;                                                                       \
+            hqueue->Stats.drops++;                                                                  \
+        }                                                                                           \
+        else                                                                                        \
+        {                                                                                           \
+            hqueue->Buffer[ hqueue->Tail ] = *data;                                                 \
+            hqueue->Tail = ( hqueue->Tail == ( ( uint32_t ) ( elements ) - 1u ) ) ? 0u : ( hqueue->Tail + 1u ); \
+            hqueue->SavedElements++;                                                                \
+            HIL_QUEUE_WriteStats( &hqueue->Stats, 1u, hqueue->SavedElements );                      \
+            valueToReturn = QUEUE_OK;                                                               \
+        }                                                                                           \
+        return valueToReturn;                                                                       \
+    }                                                                                               \
+                                                                                                    \
+    static inline void HIL_QUEUE_Overwrite##name( QUEUE_##name##_TypeDef *hqueue, const type *data ) \
+    {                                                                                               \
+        if( hqueue->SavedElements == ( uint32_t ) ( elements ) )                                    \
+        {                                                                                           \
+            hqueue->Head = ( hqueue->Head == ( ( uint32_t ) ( elements ) - 1u ) ) ? 0u : ( hqueue->Head + 1u ); \
+            hqueue->SavedElements--;                                                                \
+            hqueue->Stats.drops++;                                                                  \
+        }                                                                                           \
+        ( void ) HIL_QUEUE_Write##name( hqueue, data );                                             \
+    }                                                                                               \
+                                                                                                    \
+    static inline uint8_t HIL_QUEUE_Read##name( QUEUE_##name##_TypeDef *hqueue, type *data )        \
+    {                                                                                               \
+        uint8_t valueToReturn = QUEUE_NOT_OK;                                                       \
+        if( hqueue->SavedElements == 0u )                                                           \
+        {                                                                                           \
+            hqueue->Empty = 1;                                                                      \
+        }                                                                                           \
+        else                                                                                        \
+        {                                                                                           \
+            *data = hqueue->Buffer[ hqueue->Head ];                                                 \
+            hqueue->Head = ( hqueue->Head == ( ( uint32_t ) ( elements ) - 1u ) ) ? 0u : ( hqueue->Head + 1u ); \
+            hqueue->SavedElements--;                                                                \
+            hqueue->Stats.reads++;                                                                  \
+            valueToReturn = QUEUE_OK;                                                               \
+        }                                                                                           \
+        return valueToReturn;                                                                       \
+    }                                                                                               \
+                                                                                                    \
+    static inline uint32_t HIL_QUEUE_ReadN##name( QUEUE_##name##_TypeDef *hqueue, type *data, uint32_t n ) \
+    {                                                                                               \
+        uint32_t Count = 0;                                                                         \
+        while( ( Count < n ) && ( HIL_QUEUE_Read##name( hqueue, &data[ Count ] ) == ( uint8_t ) QUEUE_OK ) ) \
+        {                                                                                           \
+            Count++;                                                                                \
+        }                                                                                           \
+        return Count;                                                                               \
+    }                                                                                               \
+                                                                                                    \
+    static inline uint8_t HIL_QUEUE_IsEmpty##name( const QUEUE_##name##_TypeDef *hqueue )           \
+    {                                                                                               \
+        return ( hqueue->SavedElements == 0u );                                                     \
+    }                                                                                               \
+                                                                                                    \
+    static inline void HIL_QUEUE_GetStats##name( const QUEUE_##name##_TypeDef *hqueue, QUEUE_StatsTypeDef *stats ) \
+    {                                                                                               \
+        *stats = hqueue->Stats;                                                                     \
+    }                                                                                               \
+                                                                                                    \
+    static inline uint8_t HIL_QUEUE_Write##name##ISR( QUEUE_##name##_TypeDef *hqueue, const type *data, uint8_t isr ) \
+    {                                                                                               \
+        uint8_t valueToReturn;                                                                      \
+        HIL_QUEUE_Lock( isr );                                                                      \
+        valueToReturn = HIL_QUEUE_Write##name( hqueue, data );                                      \
+        HIL_QUEUE_Unlock( isr );                                                                    \
+        return valueToReturn;                                                                       \
+    }                                                                                               \
+                                                                                                    \
+    static inline void HIL_QUEUE_Overwrite##name##ISR( QUEUE_##name##_TypeDef *hqueue, const type *data, uint8_t isr ) \
+    {                                                                                               \
+        HIL_QUEUE_Lock( isr );                                                                      \
+        HIL_QUEUE_Overwrite##name( hqueue, data );                                                  \
+        HIL_QUEUE_Unlock( isr );                                                                    \
+    }                                                                                               \
+                                                                                                    \
+    static inline uint8_t HIL_QUEUE_Read##name##ISR( QUEUE_##name##_TypeDef *hqueue, type *data, uint8_t isr ) \
+    {                                                                                               \
+        uint8_t valueToReturn;                                                                      \
+        HIL_QUEUE_Lock( isr );                                                                      \
+        valueToReturn = HIL_QUEUE_Read##name( hqueue, data );                                       \
+        HIL_QUEUE_Unlock( isr );                                                                    \
+        return valueToReturn;                                                                       \
+    }                                                                                               \
+                                                                                                    \
+    static inline uint32_t HIL_QUEUE_ReadN##name##ISR( QUEUE_##name##_TypeDef *hqueue, type *data, uint32_t n, uint8_t isr ) \
+    {                                                                                               \
+        uint32_t valueToReturn;                                                                     \
+        HIL_QUEUE_Lock( isr );                                                                      \
+        valueToReturn = HIL_QUEUE_ReadN##name( hqueue, data, n );                                   \
+        HIL_QUEUE_Unlock( isr );                                                                    \
+        return valueToReturn;                                                                       \
+    }                                                                                               \
+                                                                                                    \
+    typedef char QUEUE_##name##_Check[ ( ( elements ) > 0u ) ? 1 : -1 ]
+
 #endif
\ No newline at end of file
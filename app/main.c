@@ -25,6 +25,59 @@ static void Pet_The_Dog( void );
   */
  WWDG_HandleTypeDef WDGHandler = {0};
 
+/**
+ * @brief  Scheduler handler, global so the interrupts can notify tasks.
+ */
+Scheduler_HandleTypeDef Sche;
+
+#if SCHEDULER_STATIC_TASKS == 1
+/**
+ * @brief  List of tasks with their init functions, their periodicity and their offset, the task IDs
+ * follow the order of the list starting from #1.
+ */
+#define SCHEDULER_TASK_LIST( TASK, arg )                \
+    TASK( arg, LED_Init, Heart_Beat, 300, 0 )           \
+    TASK( arg, Serial_Init, Serial_Task, 10, 0 )        \
+    TASK( arg, Clock_Init, Clock_Task, 50, 0 )          \
+    TASK( arg, Display_Init, Display_Task, 100, 0 )     \
+    TASK( arg, Dog_Init, Pet_The_Dog, 80, 0 )
+
+/**
+ * @brief  Position of every task in the list.
+ */
+enum
+{
+    SCHEDULER_TASK_LIST( SCHEDULER_TASK_INDEX, 0 )
+    SCHEDULER_INDEX_COUNT
+};
+
+/**
+ * @brief  Table of tasks built from the list.
+ */
+static const TaskConfig_TypeDef TasksTable[] =
+{
+    SCHEDULER_TASK_LIST( SCHEDULER_TASK_ENTRY, 0 )
+};
+
+#if SCHEDULER_CYCLIC == 1
+#include "scheduler_cyclic.h"
+#endif
+
+/*The build fails if the table does not hold TASKS_N tasks.*/
+/*cppcheck-suppress misra-c2012-2.3 ; Type used only to check the table size.*/
+typedef char TasksTableCheck[ ( ( sizeof( TasksTable ) / sizeof( TasksTable[0] ) ) == TASKS_N ) ? 1 : -1 ];
+
+/**
+ * @brief  ID of the serial task, notified by the CAN reception interrupt.
+ */
+uint8_t SerialTaskID = SCHEDULER_INDEX_Serial_Task + 1;
+#else
+/**
+ * @brief  ID of the serial task, notified by the CAN reception interrupt.
+ */
+uint8_t SerialTaskID = 0;
+#endif
+
 /**
  * @brief  Global variable for the Heartbeat function time counter.
  */
@@ -51,7 +104,6 @@ int main( void )
     HAL_StatusTypeDef Status;
     static Task_TypeDef tasks[ TASKS_N ];
     static Timer_TypeDef timers[ TIMERS_N ];
-    static Scheduler_HandleTypeDef Sche;
 
     /*The function is used and its result is verified.*/
     Status = HAL_Init();
@@ -64,14 +116,23 @@ int main( void )
     Sche.taskPtr = tasks;
     Sche.timers = TIMERS_N;
     Sche.timerPtr = timers;
+#if SCHEDULER_STATIC_TASKS == 1
+    Sche.configPtr = TasksTable;
+#if SCHEDULER_CYCLIC == 1
+    Sche.cyclicPtr = SchedulerCyclicTable;
+    Sche.cyclicSlots = SCHEDULER_CYCLIC_SLOTS;
+#endif
+    HIL_SCHEDULER_Init( &Sche );
+#else
     HIL_SCHEDULER_Init( &Sche );
 
     /*Register tasks with thier corresponding init fucntions and their periodicyt*/
     ( void )HIL_SCHEDULER_RegisterTask( &Sche, LED_Init, Heart_Beat, 300 );
-    ( void )HIL_SCHEDULER_RegisterTask( &Sche, Serial_Init, Serial_Task, 10 );
+    SerialTaskID = HIL_SCHEDULER_RegisterTask( &Sche, Serial_Init, Serial_Task, 10 );
     ( void )HIL_SCHEDULER_RegisterTask( &Sche, Clock_Init, Clock_Task, 50 );
     ( void )HIL_SCHEDULER_RegisterTask( &Sche, Display_Init, Display_Task, 100 );
-    ( void )HIL_SCHEDULER_RegisterTask( &Sche, Dog_Init, Pet_The_Dog, 75 );
+    ( void )HIL_SCHEDULER_RegisterTask( &Sche, Dog_Init, Pet_The_Dog, 80 );
+#endif
         
     /*Run the scheduler in a infinite loop*/
     HIL_SCHEDULER_Start( &Sche );
@@ -111,7 +172,7 @@ static void LED_Init( void ) {
  * With Window value of 94:
  * tWWDG = ( 1 / ( 32MHz / 4096 ) / 16 ) * ( 94 + 1 ) = 0.1946 s = 194.6 ms
  * Difference:
- * 262.2 ms  - 194.6 ms = 67.6 ms --> Refresh > 67.6 ms ∴ 75 ms proposed.
+ * 262.2 ms  - 194.6 ms = 67.6 ms --> Refresh > 67.6 ms ∴ 80 ms proposed, the nearest multiple of the tick.
  *
  * @param   WDGHandler[out] Structure-type variable to save the configuration of the Watchdog registers.
  *
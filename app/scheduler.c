@@ -5,12 +5,117 @@
 
 #include "app_bsp.h"
 
+/** 
+ * @defgroup <Wheel slot values of the timers that are not linked to the wheel.>
+ @{ */
+#define TIMER_NO_SLOT       0xFFFFFFFFu /*!< The timer is not running.*/
+#define TIMER_EXPIRED       0xFFFFFFFEu /*!< The timer expired and its callback is about to run.*/
+/**
+ @} */
+
+#if SCHEDULER_STACK_MONITOR == 1
+#define STACK_PAINT         0xC5C5C5C5u /*!< Pattern of the stack words never used.*/
+
+/*cppcheck-suppress misra-c2012-8.4 ; Symbols defined by the linker script.*/
+extern uint32_t _sstack;
+/*cppcheck-suppress misra-c2012-8.4 ; Symbols defined by the linker script.*/
+extern uint32_t _estack;
+#endif
+
+#if ( SCHEDULER_WHEEL_SLOTS & ( SCHEDULER_WHEEL_SLOTS - 1 ) ) != 0
+#error "SCHEDULER_WHEEL_SLOTS must be a power of two"
+#endif
+
+/** 
+ * @defgroup <Access to the task configuration, taken from the const table in flash with
+ * SCHEDULER_STATIC_TASKS or from the TCBs registered in RAM otherwise.>
+ @{ */
+#if SCHEDULER_STATIC_TASKS == 1
+#define TASK_PERIOD( hs, i )    ( ( hs )->configPtr[i].period )
+#define TASK_INIT( hs, i )      ( ( hs )->configPtr[i].initFunc )
+#define TASK_FUNC( hs, i )      ( ( hs )->configPtr[i].taskFunc )
+#define TASK_RUNNING( hs, i )   ( ( hs )->taskPtr[i].stopped == 0u )
+#else
+#define TASK_PERIOD( hs, i )    ( ( hs )->taskPtr[i].period )
+#define TASK_INIT( hs, i )      ( ( hs )->taskPtr[i].initFunc )
+#define TASK_FUNC( hs, i )      ( ( hs )->taskPtr[i].taskFunc )
+#define TASK_RUNNING( hs, i )   ( ( hs )->taskPtr[i].taskFunc != NULL )
+#endif
+/**
+ @} */
+
+/**
+ * @defgroup <Due state of a task, taken from the cyclic executive table with SCHEDULER_CYCLIC or
+ * from the time elapsed since the last execution otherwise.>
+ @{ */
+#if SCHEDULER_CYCLIC == 1
+#define TASK_DUE( hs, i )       ( ( ( hs )->due & ( ( uint32_t ) 1 << ( i ) ) ) != 0u )
+#define TASK_DONE( hs, i )      ( ( hs )->due &= ~( ( uint32_t ) 1 << ( i ) ) )
+#else
+#define TASK_DUE( hs, i )       ( ( hs )->taskPtr[i].elapsed >= TASK_PERIOD( hs, i ) )
+#define TASK_DONE( hs, i )      ( ( hs )->taskPtr[i].elapsed = 0 )
+#endif
+/**
+ @} */
+
+#if ( SCHEDULER_CYCLIC == 1 ) && ( SCHEDULER_STATIC_TASKS == 0 )
+#error "SCHEDULER_CYCLIC needs SCHEDULER_STATIC_TASKS"
+#endif
+
+/**
+ * @brief Macro with the checks of the registered tasks repeated by the task functions, a static
+ * table is checked at build time so there is nothing left to check at run time.
+*/
+#if SCHEDULER_STATIC_TASKS == 1
+#define SCHEDULER_CHECK_TASKS( hs )     ( void ) ( hs )
+#else
+#define SCHEDULER_CHECK_TASKS( hs )                                                                                             \
+    do {                                                                                                                        \
+        assert_error( ( ( hs )->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/ \
+        assert_error( ( ( hs )->tick != 0u ), SCHEDULER_PAR_ERROR );                  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/ \
+        assert_error( ( ( hs )->taskPtr->period != 0u ), SCHEDULER_PAR_ERROR );       /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/ \
+        assert_error( ( ( hs )->taskPtr->initFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/ \
+        assert_error( ( ( hs )->taskPtr->taskFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/ \
+    } while( 0 )
+#endif
+
 /**
  * @brief Structure for the TIM6 handler.
 */
 extern TIM_HandleTypeDef TIM6_Handler;
 TIM_HandleTypeDef TIM6_Handler = {0};
 
+#if SCHEDULER_LOW_POWER == 1
+static uint32_t HIL_SCHEDULER_NextDeadline( Scheduler_HandleTypeDef *hscheduler );
+#endif
+static void HIL_SCHEDULER_RunTask( Scheduler_HandleTypeDef *hscheduler, uint32_t task );
+static uint32_t HIL_SCHEDULER_NextTask( Scheduler_HandleTypeDef *hscheduler );
+static void HIL_SCHEDULER_CheckJitter( Scheduler_HandleTypeDef *hscheduler, uint32_t task, uint32_t interval );
+static void HIL_SCHEDULER_Miss( Scheduler_HandleTypeDef *hscheduler, uint32_t task, uint32_t interval );
+static void HIL_SCHEDULER_Overdue( Scheduler_HandleTypeDef *hscheduler, uint32_t task );
+#if SCHEDULER_TICK_BUDGET > 0
+static void HIL_SCHEDULER_DeferDue( Scheduler_HandleTypeDef *hscheduler );
+#endif
+static void HIL_SCHEDULER_LinkTimer( Scheduler_HandleTypeDef *hscheduler, Timer_TypeDef *timer, uint32_t time );
+static void HIL_SCHEDULER_UnlinkTimer( Scheduler_HandleTypeDef *hscheduler, Timer_TypeDef *timer );
+static uint32_t HIL_SCHEDULER_RemainingTimer( Scheduler_HandleTypeDef *hscheduler, Timer_TypeDef *timer );
+static void HIL_SCHEDULER_AdvanceTimers( Scheduler_HandleTypeDef *hscheduler, uint32_t ticks );
+#if ( SCHEDULER_PROFILER == 1 ) || ( SCHEDULER_LOAD_METER == 1 )
+static uint32_t HIL_SCHEDULER_TimeSince( uint32_t tickStart, uint16_t countStart );
+#endif
+#if ( SCHEDULER_AUTO_PHASE == 1 ) && ( SCHEDULER_CYCLIC == 0 )
+static void HIL_SCHEDULER_AssignPhases( Scheduler_HandleTypeDef *hscheduler );
+static uint32_t HIL_SCHEDULER_Gcd( uint32_t a, uint32_t b );
+#endif
+#if SCHEDULER_LOAD_METER == 1
+static void HIL_SCHEDULER_UpdateLoad( Scheduler_HandleTypeDef *hscheduler, uint32_t elapsed );
+static uint32_t HIL_SCHEDULER_MeanLoad( Scheduler_HandleTypeDef *hscheduler, uint32_t seconds );
+#endif
+#if SCHEDULER_STACK_MONITOR == 1
+static void HIL_SCHEDULER_PaintStack( uint32_t depth );
+static void HIL_SCHEDULER_CheckStack( Scheduler_HandleTypeDef *hscheduler, uint32_t *depth );
+#endif
+
 /**
  * @brief Function to initialice the task count.
  * The hscheduler structure initialices with the values passed as parameters.
@@ -21,12 +126,76 @@ void HIL_SCHEDULER_Init( Scheduler_HandleTypeDef *hscheduler )
     assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR ); /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.'*/
     assert_error( ( hscheduler->tick != 0u ), SCHEDULER_PAR_ERROR );  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
     
+    hscheduler->pending = 0;
+#if SCHEDULER_DEFER_N > 0
+    hscheduler->deferQueue.Buffer = hscheduler->deferBuffer;
+    hscheduler->deferQueue.Elements = SCHEDULER_DEFER_N;
+    hscheduler->deferQueue.Size = sizeof( Deferred_TypeDef );
+    HIL_QUEUE_Init( &hscheduler->deferQueue );
+#endif
+#if SCHEDULER_STATIC_TASKS == 1
+    /*The table was checked against TICK_VAL when it was built.*/
+    assert_error( ( hscheduler->tick == ( uint32_t ) TICK_VAL ), SCHEDULER_PAR_ERROR );  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( hscheduler->configPtr != NULL ), SCHEDULER_PAR_ERROR );              /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+
+    /*Every task of the table is registered in the same order, starting as task #1.*/
+    hscheduler->tasksCount = hscheduler->tasks;
+#if SCHEDULER_CYCLIC == 1
+    assert_error( ( hscheduler->cyclicPtr != NULL ), SCHEDULER_PAR_ERROR );              /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( hscheduler->cyclicSlots != 0u ), SCHEDULER_PAR_ERROR );              /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( hscheduler->tasks <= 32u ), SCHEDULER_PAR_ERROR );                   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    hscheduler->cyclicCursor = 0;
+    hscheduler->due = 0;
+#endif
+    for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
+    {
+        hscheduler->taskPtr[i].elapsed = 0;
+        hscheduler->taskPtr[i].stopped = 0;
+        hscheduler->taskPtr[i].ready = 0;
+        hscheduler->taskPtr[i].priority = hscheduler->configPtr[i].period;
+        hscheduler->taskPtr[i].offset = hscheduler->configPtr[i].offset;
+        hscheduler->taskPtr[i].lastRun = 0;
+        ( void ) memset( &hscheduler->taskPtr[i].jitter, 0, sizeof( TaskJitter_TypeDef ) );
+#if SCHEDULER_TICK_BUDGET > 0
+        hscheduler->taskPtr[i].deferrals = 0;
+#endif
+#if SCHEDULER_PROFILER == 1
+        ( void ) memset( &hscheduler->taskPtr[i].stats, 0, sizeof( TaskStats_TypeDef ) );
+        hscheduler->taskPtr[i].stats.minTime = 0xFFFFFFFFu;
+#endif
+#if SCHEDULER_STACK_MONITOR == 1
+        hscheduler->taskPtr[i].stackDepth = 0;
+#endif
+    }
+#else
     hscheduler->tasksCount = 0;
+#endif
+    hscheduler->timersCount = 0;
+    hscheduler->wheelCursor = 0;
+#if SCHEDULER_LOAD_METER == 1
+    hscheduler->tickBusy = 0;
+    hscheduler->secondBusy = 0;
+    hscheduler->secondStart = 0;
+    hscheduler->peakTick = 0;
+    hscheduler->loadIndex = 0;
+    hscheduler->loadSeconds = 0;
+#endif
+#if SCHEDULER_STACK_MONITOR == 1
+    hscheduler->stackPeak = 0;
+    hscheduler->stackIdle = 0;
+#endif
+
+    for ( uint32_t i = 0; i < ( uint32_t ) SCHEDULER_WHEEL_SLOTS; i++ )
+    {
+        hscheduler->wheel[i] = NULL;
+    }
 }
 
+#if SCHEDULER_STATIC_TASKS == 0
 /**
  * @brief Function to register the number of tasks. 
- * The tasks are assigned a number starting from #1 to N.
+ * The tasks are assigned a number starting from #1 to N. The priority of the task starts as its
+ * period, so the shorter periods run first (deadline monotonic) until it is changed.
  * @param[in] hscheduler
  * @param[in] InitPtr
  * @param[in] TaskPtr
@@ -46,6 +215,21 @@ uint8_t HIL_SCHEDULER_RegisterTask( Scheduler_HandleTypeDef *hscheduler, void (*
         hscheduler->taskPtr[hscheduler->tasksCount].elapsed= 0;
         hscheduler->taskPtr[hscheduler->tasksCount].initFunc = InitPtr;
         hscheduler->taskPtr[hscheduler->tasksCount].taskFunc = TaskPtr;
+        hscheduler->taskPtr[hscheduler->tasksCount].ready = 0;
+        hscheduler->taskPtr[hscheduler->tasksCount].priority = Period;
+        hscheduler->taskPtr[hscheduler->tasksCount].offset = 0;
+        hscheduler->taskPtr[hscheduler->tasksCount].lastRun = 0;
+        ( void ) memset( &hscheduler->taskPtr[hscheduler->tasksCount].jitter, 0, sizeof( TaskJitter_TypeDef ) );
+#if SCHEDULER_TICK_BUDGET > 0
+        hscheduler->taskPtr[hscheduler->tasksCount].deferrals = 0;
+#endif
+#if SCHEDULER_PROFILER == 1
+        ( void ) memset( &hscheduler->taskPtr[hscheduler->tasksCount].stats, 0, sizeof( TaskStats_TypeDef ) );
+        hscheduler->taskPtr[hscheduler->tasksCount].stats.minTime = 0xFFFFFFFFu;
+#endif
+#if SCHEDULER_STACK_MONITOR == 1
+        hscheduler->taskPtr[hscheduler->tasksCount].stackDepth = 0;
+#endif
 
         hscheduler->tasksCount++;
 
@@ -55,6 +239,8 @@ uint8_t HIL_SCHEDULER_RegisterTask( Scheduler_HandleTypeDef *hscheduler, void (*
     return TaskID;
 }
 
+#endif
+
 /**
  * @brief Function that stops any of the previously registered tasks. 
  * The function saves in an auxiliar variable the task that was stopped before "erasing" it. 
@@ -66,17 +252,18 @@ uint8_t HIL_SCHEDULER_StopTask( Scheduler_HandleTypeDef *hscheduler, uint32_t ta
 {
     uint8_t SuccessFlag = 0;
 
-    assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->tick != 0u ), SCHEDULER_PAR_ERROR );                  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->period != 0u ), SCHEDULER_PAR_ERROR );       /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->initFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->taskFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    SCHEDULER_CHECK_TASKS( hscheduler );
 
     if ( task <= hscheduler->tasksCount )
-    {   /*Saving the function before stopping it.*/
+    {
+#if SCHEDULER_STATIC_TASKS == 1
+        hscheduler->taskPtr[task - ( uint32_t ) 1].stopped = 1;
+#else
+        /*Saving the function before stopping it.*/
         hscheduler->taskPtr[task - ( uint32_t ) 1].taskFunc1 = hscheduler->taskPtr[task - ( uint32_t ) 1 ].taskFunc;
         /*Task is stopped.*/
         hscheduler->taskPtr[task - ( uint32_t ) 1].taskFunc = NULL;
+#endif
         SuccessFlag = 1;
     }
 
@@ -94,15 +281,24 @@ uint8_t HIL_SCHEDULER_StartTask( Scheduler_HandleTypeDef *hscheduler, uint32_t t
 {
     uint8_t SuccessFlag = 0;
 
-    assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->tick != 0u ), SCHEDULER_PAR_ERROR );                  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->period != 0u ), SCHEDULER_PAR_ERROR );       /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->initFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->taskFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    SCHEDULER_CHECK_TASKS( hscheduler );
 
     if (task <= hscheduler->tasksCount)
-    {   /*The function that was previuouly saved before it was stopped is assigned again.*/
+    {
+        /*The time stopped is not taken as jitter.*/
+        hscheduler->taskPtr[task - ( uint32_t ) 1 ].lastRun = 0;
+#if SCHEDULER_STATIC_TASKS == 1
+#if SCHEDULER_CYCLIC == 1
+        /*An execution due while it was stopped is not run late.*/
+        TASK_DONE( hscheduler, task - ( uint32_t ) 1 );
+#endif
+        hscheduler->taskPtr[task - ( uint32_t ) 1 ].stopped = 0;
+#else
+        /*The function that was previuouly saved before it was stopped is assigned again.*/
         hscheduler->taskPtr[task - ( uint32_t ) 1 ].taskFunc = hscheduler->taskPtr[task - ( uint32_t ) 1 ].taskFunc1;
+#endif
+        /*The loop takes the deadline of the task again before going to sleep.*/
+        hscheduler->pending = 1;
 
         SuccessFlag = 1;
     }
@@ -110,6 +306,7 @@ uint8_t HIL_SCHEDULER_StartTask( Scheduler_HandleTypeDef *hscheduler, uint32_t t
     return SuccessFlag; 
 }
 
+#if SCHEDULER_STATIC_TASKS == 0
 /**
  * @brief Function that changes the period of execution of a given previously registered task.
  * 
@@ -122,39 +319,163 @@ uint8_t HIL_SCHEDULER_PeriodTask( Scheduler_HandleTypeDef *hscheduler, uint32_t
 {
     uint8_t SuccessFlag = 0;
 
-    assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->tick != 0u ), SCHEDULER_PAR_ERROR );                  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->period != 0u ), SCHEDULER_PAR_ERROR );       /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->initFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->taskFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    SCHEDULER_CHECK_TASKS( hscheduler );
 
     if ( ( period % hscheduler->tick ) == ( uint32_t ) 0 )
     {   
         hscheduler->taskPtr[task - ( uint32_t ) 1].period = period;
+        hscheduler->taskPtr[task - ( uint32_t ) 1].lastRun = 0;
+        /*The deadline of the task can come earlier than the one the loop is waiting for.*/
+        hscheduler->pending = 1;
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+#endif
+
+/**
+ * @brief Function that changes the priority of a given previously registered task.
+ * 
+ * The lower the value the more urgent the task, tasks with the same priority run in the order
+ * they were registered.
+ * 
+ * @param[in] hscheduler
+ * @param[in] task
+ * @param[in] priority
+ * @retval 	The function returns a flag: true if the task was changed successfully, and false if it wasn't.
+*/
+uint8_t HIL_SCHEDULER_PriorityTask( Scheduler_HandleTypeDef *hscheduler, uint32_t task, uint32_t priority )
+{
+    uint8_t SuccessFlag = 0;
+
+    SCHEDULER_CHECK_TASKS( hscheduler );
+
+    if ( ( task > ( uint32_t ) 0 ) && ( task <= hscheduler->tasksCount ) )
+    {
+        hscheduler->taskPtr[task - ( uint32_t ) 1].priority = priority;
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+#if SCHEDULER_CYCLIC == 0
+/**
+ * @brief Function that changes the offset of a given previously registered task.
+ * 
+ * The task runs for the first time offset ms after the scheduler starts and every period after that,
+ * with an offset of 0 it waits a whole period. Called once the scheduler runs, the task is shifted
+ * to run offset ms after the current tick.
+ * 
+ * @param[in] hscheduler
+ * @param[in] task
+ * @param[in] offset Multiple of the tick shorter than the period.
+ * @retval 	The function returns a flag: true if the task was changed successfully, and false if it wasn't.
+*/
+uint8_t HIL_SCHEDULER_OffsetTask( Scheduler_HandleTypeDef *hscheduler, uint32_t task, uint32_t offset )
+{
+    uint8_t SuccessFlag = 0;
+
+    SCHEDULER_CHECK_TASKS( hscheduler );
+
+    if ( ( task > ( uint32_t ) 0 ) && ( task <= hscheduler->tasksCount ) && ( ( offset % hscheduler->tick ) == ( uint32_t ) 0 ) && ( offset < TASK_PERIOD( hscheduler, task - ( uint32_t ) 1 ) ) )
+    {
+        hscheduler->taskPtr[task - ( uint32_t ) 1].offset = offset;
+        hscheduler->taskPtr[task - ( uint32_t ) 1].elapsed = ( TASK_PERIOD( hscheduler, task - ( uint32_t ) 1 ) - offset ) % TASK_PERIOD( hscheduler, task - ( uint32_t ) 1 );
+        hscheduler->taskPtr[task - ( uint32_t ) 1].lastRun = 0;
+        /*The deadline of the task can come earlier than the one the loop is waiting for.*/
+        hscheduler->pending = 1;
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+#endif
+
+/**
+ * @brief Function that marks a registered task as ready to run.
+ * 
+ * The function is meant to be called from an interrupt, the task runs on the next pass of the
+ * scheduler loop regardless of its period, which is not modified. A stopped task is not executed.
+ * 
+ * @param[in] hscheduler
+ * @param[in] task
+ * @retval 	The function returns a flag: true if the task was notified, and false if it doesn't exist.
+*/
+uint8_t HIL_SCHEDULER_Notify( Scheduler_HandleTypeDef *hscheduler, uint32_t task )
+{
+    uint8_t SuccessFlag = 0;
+
+    if ( ( task > ( uint32_t ) 0 ) && ( task <= hscheduler->tasksCount ) )
+    {
+        hscheduler->taskPtr[task - ( uint32_t ) 1].ready = 1;
+        hscheduler->pending = 1;
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+#if SCHEDULER_DEFER_N > 0
+/**
+ * @brief Function that queues a callback to run in the scheduler loop.
+ * 
+ * The function is meant to be called from an interrupt that has work too long for it, the callback
+ * runs with the context on the next pass of the scheduler loop, before the notified tasks. Up to
+ * SCHEDULER_DEFER_N callbacks can wait at the same time, they run in the order they were queued.
+ * 
+ * @param[in] hscheduler
+ * @param[in] CallbackPtr
+ * @param[in] Context
+ * @retval 	The function returns a flag: true if the callback was queued, and false if the queue is full.
+*/
+uint8_t HIL_SCHEDULER_Defer( Scheduler_HandleTypeDef *hscheduler, void (*CallbackPtr)(void *context), void *Context )
+{
+    uint8_t SuccessFlag = 0;
+    Deferred_TypeDef Deferred;
+
+    assert_error( ( CallbackPtr != NULL ), SCHEDULER_PAR_ERROR );                    /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+
+    Deferred.callbackPtr = CallbackPtr;
+    Deferred.context = Context;
+
+    /*All the interrupts are masked, an interrupt of higher priority could also defer a callback.*/
+    if( HIL_QUEUE_WriteISR( &hscheduler->deferQueue, &Deferred, 0xFF ) == ( uint8_t ) QUEUE_OK )
+    {
+        hscheduler->pending = 1;
         SuccessFlag = 1;
     }
 
     return SuccessFlag;
 }
+#endif
 
 /**
  * @brief Function that initialices & runs the registered tasks.
  * 
+ * The elapsed time is consumed in whole ticks, so the time base does not drift when a pass is late.
+ * With SCHEDULER_LOW_POWER the core sleeps (WFI) until the nearest task or timer deadline, any
+ * interrupt (SysTick included) wakes it up to check again. When several tasks are due in the same
+ * tick they run by priority, and with SCHEDULER_TICK_BUDGET the ones left when the budget is spent
+ * wait for the next tick, where they run before the ones left fewer times. Every tick a task is left
+ * counts as a deadline miss, like every period that ends with the task still due. Tasks notified from an interrupt run on
+ * the next pass of the loop, outside of the tick. TIM6 runs as a free 1 us counter used
+ * to measure the tasks execution time.
+ * 
  * @param[in] hscheduler
 */
 void HIL_SCHEDULER_Start( Scheduler_HandleTypeDef *hscheduler )
 {
-    assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->tick != 0u ), SCHEDULER_PAR_ERROR );                  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->period != 0u ), SCHEDULER_PAR_ERROR );       /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->initFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( ( hscheduler->taskPtr->taskFunc != NULL ), SCHEDULER_PAR_ERROR );   /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    SCHEDULER_CHECK_TASKS( hscheduler );
 
     __HAL_RCC_TIM6_CLK_ENABLE();
 
-    /*Clock APB1 = 32 MHz, Prescaler = 32000 -> APB1/Prescaler = 1 kHz ∴ t = 1 ms*/
+    /*Clock APB1 = 32 MHz, the timers run at APB1 x 2 = 64 MHz since the APB prescaler is not 1*/
     TIM6_Handler.Instance = TIM6;
-    TIM6_Handler.Init.Prescaler = 32000;                   /*APB1/Prescaler = 1 kHz ∴ t = 1 ms*/
+    TIM6_Handler.Init.Prescaler = 63;                      /*TIMCLK/(Prescaler + 1) = 1 MHz ∴ t = 1 us*/
     TIM6_Handler.Init.CounterMode = TIM_COUNTERMODE_UP;    /*Count from zero to TIM6_Handler.Init.Period*/
     TIM6_Handler.Init.Period = 0xFFFF;                     /*Count Overflow at 65535 (maximum).*/
     TIM6_Handler.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
@@ -166,198 +487,1316 @@ void HIL_SCHEDULER_Start( Scheduler_HandleTypeDef *hscheduler )
     HAL_TIM_Base_Start( &TIM6_Handler );
 
     uint32_t TimerReading;
-    uint32_t PreviousTime[TASKS_N] = {0};
-    uint32_t Difference;
-    uint32_t Deviation;
-    uint32_t UpperLimit;
-    uint32_t LowerLimit;
+#if SCHEDULER_DEFER_N > 0
+    Deferred_TypeDef Deferred;
+#endif
+    uint32_t Elapsed;
+    uint32_t Deadline = hscheduler->tick;
+    uint32_t Task;
+#if SCHEDULER_TICK_BUDGET > 0
+    uint16_t CountStart;
+#endif
+#if SCHEDULER_LOAD_METER == 1
+    uint32_t BusyTick;
+    uint16_t BusyCount;
+#endif
+
+#if ( SCHEDULER_AUTO_PHASE == 1 ) && ( SCHEDULER_CYCLIC == 0 )
+    HIL_SCHEDULER_AssignPhases( hscheduler );
+#endif
+
+    /*Every task starts its first period shortened by its offset.*/
+    for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
+    {
+        hscheduler->taskPtr[i].elapsed = ( TASK_PERIOD( hscheduler, i ) - hscheduler->taskPtr[i].offset ) % TASK_PERIOD( hscheduler, i );
+    }
 
     uint32_t tickstart = HAL_GetTick();
 
+#if SCHEDULER_STACK_MONITOR == 1
+    HIL_SCHEDULER_PaintStack( ( uint32_t ) ( ( uint8_t * ) &_estack - ( uint8_t * ) &_sstack ) );
+#endif
+
     /*Execution of the task initialization routines.*/
     for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
     {           
-        if( hscheduler->taskPtr[i].initFunc != NULL ) {
-            hscheduler->taskPtr[i].initFunc();
+        if( TASK_INIT( hscheduler, i ) != NULL ) {
+            TASK_INIT( hscheduler, i )();
         }
     }
+#if SCHEDULER_STACK_MONITOR == 1
+    HIL_SCHEDULER_CheckStack( hscheduler, &hscheduler->stackPeak );
+#endif
+
+#if SCHEDULER_LOAD_METER == 1
+    hscheduler->secondStart = HAL_GetTick();
+#endif
 
     /*Execution of the tasks.*/
     while (1)
     {
-        if ( ( HAL_GetTick() - tickstart ) >= hscheduler->tick )
+        if( hscheduler->pending != 0u )
         {
-            tickstart = HAL_GetTick();
-
-            for ( uint32_t i = 0; i < hscheduler->timers; i++ )
-            { 
-                if( ( hscheduler->timerPtr[i].StartFlag ) && ( hscheduler->timerPtr[i].callbackPtr !=NULL ) )
-                {   
-                    hscheduler->timerPtr[i].Count -=  hscheduler->tick;
-                    if( hscheduler->timerPtr[i].Count == 0u )
+#if SCHEDULER_LOAD_METER == 1
+            BusyTick = HAL_GetTick();
+            BusyCount = ( uint16_t ) __HAL_TIM_GET_COUNTER( &TIM6_Handler );
+#endif
+            /*Cleared before the scan, a notification arriving meanwhile is kept for the next pass.*/
+            hscheduler->pending = 0;
+
+#if SCHEDULER_DEFER_N > 0
+            while( HIL_QUEUE_ReadISR( &hscheduler->deferQueue, &Deferred, 0xFF ) == ( uint8_t ) QUEUE_OK )
+            {
+                Deferred.callbackPtr( Deferred.context );
+            }
+#endif
+#if SCHEDULER_STACK_MONITOR == 1
+            HIL_SCHEDULER_CheckStack( hscheduler, &hscheduler->stackIdle );
+#endif
+
+            for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
+            {
+                if( hscheduler->taskPtr[i].ready != 0u )
+                {
+                    hscheduler->taskPtr[i].ready = 0;
+                    if( TASK_RUNNING( hscheduler, i ) )
                     {
-                        hscheduler->timerPtr[i].callbackPtr();
+                        HIL_SCHEDULER_RunTask( hscheduler, i );
                     }
                 }
             }
+#if SCHEDULER_LOAD_METER == 1
+            hscheduler->tickBusy += HIL_SCHEDULER_TimeSince( BusyTick, BusyCount );
+#endif
+#if SCHEDULER_LOW_POWER == 1
+            /*A task or a timer started since the last tick can be due before the deadline taken then.*/
+            Deadline = HIL_SCHEDULER_NextDeadline( hscheduler );
+#endif
+        }
+
+        Elapsed = HAL_GetTick() - tickstart;
+
+        if ( Elapsed >= Deadline )
+        {
+            /*Only whole ticks are consumed, the remainder is kept for the next pass.*/
+            Elapsed -= Elapsed % hscheduler->tick;
+            tickstart += Elapsed;
+#if SCHEDULER_TICK_BUDGET > 0
+            CountStart = ( uint16_t ) __HAL_TIM_GET_COUNTER( &TIM6_Handler );
+#endif
+#if SCHEDULER_LOAD_METER == 1
+            BusyTick = HAL_GetTick();
+            BusyCount = ( uint16_t ) __HAL_TIM_GET_COUNTER( &TIM6_Handler );
+#endif
 
+            HIL_SCHEDULER_AdvanceTimers( hscheduler, Elapsed / hscheduler->tick );
+#if SCHEDULER_STACK_MONITOR == 1
+            /*Also takes the interrupts served while the scheduler was idle.*/
+            HIL_SCHEDULER_CheckStack( hscheduler, &hscheduler->stackIdle );
+#endif
+
+#if SCHEDULER_CYCLIC == 1
+            /*The table says which tasks are due on every tick of the hyperperiod.*/
+            for ( uint32_t i = 0; i < ( Elapsed / hscheduler->tick ); i++ )
+            {
+                hscheduler->cyclicCursor = ( hscheduler->cyclicCursor + 1u ) % hscheduler->cyclicSlots;
+                /*A task due again while the previous execution is still due has missed that one.*/
+                for ( uint32_t j = 0; j < hscheduler->tasksCount; j++ )
+                {
+                    if( ( TASK_RUNNING( hscheduler, j ) ) && ( TASK_DUE( hscheduler, j ) ) && ( ( hscheduler->cyclicPtr[hscheduler->cyclicCursor] & ( ( uint32_t ) 1 << j ) ) != 0u ) )
+                    {
+                        HIL_SCHEDULER_Overdue( hscheduler, j );
+                    }
+                }
+                hscheduler->due |= hscheduler->cyclicPtr[hscheduler->cyclicCursor];
+            }
+#else
             for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
             {
-                if( hscheduler->taskPtr[i].taskFunc != NULL )
+                if( TASK_RUNNING( hscheduler, i ) )
                 {
-                    hscheduler->taskPtr[i].elapsed += hscheduler->tick;
-                    if( hscheduler->taskPtr[i].elapsed >= hscheduler->taskPtr[i].period ) 
+                    hscheduler->taskPtr[i].elapsed += Elapsed;
+                    /*Every period that ended with the task still due is a miss, the executions lost are not run late.*/
+                    while( hscheduler->taskPtr[i].elapsed >= ( 2u * TASK_PERIOD( hscheduler, i ) ) )
                     {
-                        TimerReading  = __HAL_TIM_GET_COUNTER( &TIM6_Handler );
-                        Difference = TimerReading - PreviousTime[i];
-                        Deviation = (hscheduler->taskPtr[i].period * 10u) / 100u;
+                        hscheduler->taskPtr[i].elapsed -= TASK_PERIOD( hscheduler, i );
+                        HIL_SCHEDULER_Overdue( hscheduler, i );
+                    }
+                }
+            }
+#endif
+
+            /*The due tasks run from the most to the least urgent.*/
+            Task = HIL_SCHEDULER_NextTask( hscheduler );
+            while( Task < hscheduler->tasksCount )
+            {
+                TimerReading  = HAL_GetTick();
 
-                        UpperLimit = hscheduler->taskPtr[i].period + Deviation;
-                        LowerLimit = hscheduler->taskPtr[i].period - Deviation;
+                /*The first activation has no previous one to compare with.*/
+                if( hscheduler->taskPtr[Task].lastRun != 0u )
+                {
+                    HIL_SCHEDULER_CheckJitter( hscheduler, Task, TimerReading - hscheduler->taskPtr[Task].lastRun );
+                }
+#if SCHEDULER_TICK_BUDGET > 0
+                hscheduler->taskPtr[Task].deferrals = 0;
+#endif
 
-                        assert_error( ! ( ( Difference >= LowerLimit ) && ( Difference <= UpperLimit ) ), SCHEDULER_TASK_ERROR ); /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+                TASK_DONE( hscheduler, Task );
+                HIL_SCHEDULER_RunTask( hscheduler, Task );
 
-                        hscheduler->taskPtr[i].elapsed = 0;
-                        hscheduler->taskPtr[i].taskFunc();
+                hscheduler->taskPtr[Task].lastRun = TimerReading;
 
-                        PreviousTime[i] = TimerReading;
-                    }
+                Task = HIL_SCHEDULER_NextTask( hscheduler );
+#if SCHEDULER_TICK_BUDGET > 0
+                /*Once the budget of the tick is spent, the tasks still due are left for the next tick.*/
+                if( ( Task < hscheduler->tasksCount ) && ( ( uint16_t ) ( ( uint16_t ) __HAL_TIM_GET_COUNTER( &TIM6_Handler ) - CountStart ) >= ( uint16_t ) SCHEDULER_TICK_BUDGET ) )
+                {
+                    HIL_SCHEDULER_DeferDue( hscheduler );
+                    Task = hscheduler->tasksCount;
                 }
+#endif
             }
 
+#if SCHEDULER_LOAD_METER == 1
+            hscheduler->tickBusy += HIL_SCHEDULER_TimeSince( BusyTick, BusyCount );
+            HIL_SCHEDULER_UpdateLoad( hscheduler, Elapsed );
+#endif
+
+#if SCHEDULER_LOW_POWER == 1
+            Deadline = HIL_SCHEDULER_NextDeadline( hscheduler );
+#endif
+        }
+        else
+        {
+#if SCHEDULER_LOW_POWER == 1
+            /*Nothing is due yet, sleep until the next interrupt. With the interrupts masked a
+            notification cannot slip in between the check and the WFI, which still wakes up on it.*/
+            __disable_irq();
+            if( hscheduler->pending == 0u )
+            {
+                HAL_PWR_EnterSLEEPMode( PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI );
+            }
+            __enable_irq();
+#endif
         }
     }
 }
 
 /**
- * @brief Function to register a new Timer.
+ * @brief Function to look for the most urgent task among the ones that are due.
  * 
  * @param[in] hscheduler
- * @param[in] Timeout
- * @param[in] CallbackPtr
+ * @retval  The index of the task in the TCB buffer, or the number of tasks if none is due.
 */
-uint8_t HIL_SCHEDULER_RegisterTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timeout, void (*CallbackPtr)(void) )
+static uint32_t HIL_SCHEDULER_NextTask( Scheduler_HandleTypeDef *hscheduler )
 {
-    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    uint8_t TimerID = 0;
-    
-    if ( ( Timeout >= hscheduler->tick ) && ( ( Timeout % hscheduler->tick ) == ( uint32_t ) 0 ) ) {
+    uint32_t Task = hscheduler->tasksCount;
 
-        hscheduler->timerPtr[hscheduler->timers].Timeout = Timeout;
-        hscheduler->timerPtr[hscheduler->timers].Count = Timeout;
-        hscheduler->timerPtr[hscheduler->timers].StartFlag = 0;
-        hscheduler->timerPtr[hscheduler->timers].callbackPtr = CallbackPtr;
-
-        hscheduler->timers++;
-
-        TimerID = hscheduler->timers;
+    for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
+    {
+        if( ( TASK_RUNNING( hscheduler, i ) ) && ( TASK_DUE( hscheduler, i ) ) )
+        {
+#if SCHEDULER_TICK_BUDGET > 0
+            /*A task left by the budget more times goes first, regardless of its priority.*/
+            if( ( Task == hscheduler->tasksCount ) ||
+                ( hscheduler->taskPtr[i].deferrals > hscheduler->taskPtr[Task].deferrals ) ||
+                ( ( hscheduler->taskPtr[i].deferrals == hscheduler->taskPtr[Task].deferrals ) && ( hscheduler->taskPtr[i].priority < hscheduler->taskPtr[Task].priority ) ) )
+#else
+            if( ( Task == hscheduler->tasksCount ) || ( hscheduler->taskPtr[i].priority < hscheduler->taskPtr[Task].priority ) )
+#endif
+            {
+                Task = i;
+            }
+        }
     }
 
-    return TimerID;
+    return Task;
 }
 
 /**
- * @brief Function to read the Timer count.
+ * @brief Function to add the time between two periodic executions of a task to its jitter histogram.
+ * 
+ * The deviation from the period goes to the bin of its power of two in ms: 0, 1, 2-3, 4-7 and so on,
+ * the last bin takes everything above. A deviation over SCHEDULER_MISS_TOLERANCE percent of the
+ * period is a deadline miss, what happens then depends on SCHEDULER_MISS_ACTION. The periods that end
+ * before the task gets to run are counted from the tick by HIL_SCHEDULER_Overdue.
  * 
  * @param[in] hscheduler
- * @param[in] Timer
+ * @param[in] task Index of the task in the TCB buffer.
+ * @param[in] interval Time in ms since the previous periodic execution.
 */
-uint32_t HIL_SCHEDULER_GetTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer )
+static void HIL_SCHEDULER_CheckJitter( Scheduler_HandleTypeDef *hscheduler, uint32_t task, uint32_t interval )
 {
-    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    
-    uint32_t CounterReading = 0;
-    
-    if ( ( Timer > ( uint32_t ) 0 ) && ( Timer <= hscheduler->timers ) )
+    TaskJitter_TypeDef *Jitter = &hscheduler->taskPtr[task].jitter;
+    uint32_t Period = TASK_PERIOD( hscheduler, task );
+    uint32_t Deviation = ( interval > Period ) ? ( interval - Period ) : ( Period - interval );
+    uint32_t Bin = 0;
+
+    while( ( Bin < ( ( uint32_t ) SCHEDULER_JITTER_BINS - 1u ) ) && ( Deviation >= ( ( uint32_t ) 1 << Bin ) ) )
     {
-        CounterReading = hscheduler->timerPtr[Timer - ( uint32_t ) 1].Count;
+        Bin++;
     }
+    Jitter->bins[Bin]++;
 
-    return CounterReading;
+    if( Deviation > Jitter->maxDeviation )
+    {
+        Jitter->maxDeviation = Deviation;
+    }
+
+    if( Deviation > ( ( Period * ( uint32_t ) SCHEDULER_MISS_TOLERANCE ) / 100u ) )
+    {
+#if SCHEDULER_TICK_BUDGET > 0
+        /*A task left by the budget already counted a miss on every tick it waited.*/
+        if( hscheduler->taskPtr[task].deferrals == 0u )
+        {
+            HIL_SCHEDULER_Miss( hscheduler, task, interval );
+        }
+#else
+        HIL_SCHEDULER_Miss( hscheduler, task, interval );
+#endif
+    }
+    else
+    {
+        Jitter->missRun = 0;
+    }
 }
 
 /**
- * @brief Function to set the Timer at it's maximum value.
- *
+ * @brief Function to count a deadline miss of a task, what happens then depends on SCHEDULER_MISS_ACTION.
+ * 
  * @param[in] hscheduler
- * @param[in] Timer
- * @param[in] Timeout
+ * @param[in] task Index of the task in the TCB buffer.
+ * @param[in] interval Time in ms since the previous periodic execution, 0 before the first one.
 */
-uint8_t HIL_SCHEDULER_ReloadTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer, uint32_t Timeout )
+static void HIL_SCHEDULER_Miss( Scheduler_HandleTypeDef *hscheduler, uint32_t task, uint32_t interval )
 {
-    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    
-    uint8_t SuccessFlag = 0;
-    
-    if ( ( Timer > ( uint32_t ) 0 ) &&  ( Timer <= hscheduler->timers ) )
+    TaskJitter_TypeDef *Jitter = &hscheduler->taskPtr[task].jitter;
+
+    Jitter->misses++;
+    Jitter->missRun++;
+#if SCHEDULER_MISS_ACTION != SCHEDULER_MISS_COUNT
+    HIL_SCHEDULER_MissCallback( task + 1u, interval );
+#else
+    ( void ) interval;
+#endif
+#if SCHEDULER_MISS_ACTION == SCHEDULER_MISS_ESCALATE
+    assert_error( ( Jitter->missRun < ( uint32_t ) SCHEDULER_MISS_LIMIT ), SCHEDULER_TASK_ERROR ); /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+#endif
+}
+
+/**
+ * @brief Function to count the miss of a task whose period ended while it was still due.
+ * 
+ * It is called from the tick, so the miss action is taken even if the task does not get to run.
+ * A task left by the budget is not counted, it already counts a miss on every tick it waits.
+ * 
+ * @param[in] hscheduler
+ * @param[in] task Index of the task in the TCB buffer.
+*/
+static void HIL_SCHEDULER_Overdue( Scheduler_HandleTypeDef *hscheduler, uint32_t task )
+{
+#if SCHEDULER_TICK_BUDGET > 0
+    if( hscheduler->taskPtr[task].deferrals == 0u )
+#endif
     {
-        hscheduler->timerPtr[Timer - ( uint32_t ) 1].Timeout = Timeout;
-        hscheduler->timerPtr[Timer - ( uint32_t ) 1].Count = Timeout;
-        
-        SuccessFlag = 1;
+        HIL_SCHEDULER_Miss( hscheduler, task, ( hscheduler->taskPtr[task].lastRun != 0u ) ? ( HAL_GetTick() - hscheduler->taskPtr[task].lastRun ) : 0u );
     }
-
-    return SuccessFlag;
 }
 
+#if SCHEDULER_TICK_BUDGET > 0
 /**
- * @brief Function to make the Timer start counting.
+ * @brief Function to leave for the next tick the tasks still due when the budget of the tick is spent.
+ * 
+ * Every task left counts a deadline miss and goes before the tasks left fewer times on the next
+ * tick, so a low priority task is not kept waiting by the ones above it.
  * 
  * @param[in] hscheduler
- * @param[in] Timer
 */
-uint8_t HIL_SCHEDULER_StartTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer )
+static void HIL_SCHEDULER_DeferDue( Scheduler_HandleTypeDef *hscheduler )
 {
-    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    
-    uint8_t SuccessFlag = 0;
-    
-    if ( ( Timer > ( uint32_t ) 0 ) && ( hscheduler->timers >= (uint32_t) 1 ) )
+    uint32_t Now = HAL_GetTick();
+
+    for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
     {
-        hscheduler->timerPtr[Timer - ( uint32_t ) 1].StartFlag = ( uint32_t ) 1;
-        SuccessFlag = 1;
+        if( ( TASK_RUNNING( hscheduler, i ) ) && ( TASK_DUE( hscheduler, i ) ) )
+        {
+            hscheduler->taskPtr[i].deferrals++;
+            HIL_SCHEDULER_Miss( hscheduler, i, ( hscheduler->taskPtr[i].lastRun != 0u ) ? ( Now - hscheduler->taskPtr[i].lastRun ) : 0u );
+        }
     }
+}
+#endif
 
-    return SuccessFlag;
+/*cppcheck-suppress misra-c2012-8.7 ; Function is necessary to declare with weak*/
+/**
+ * @brief Function called on every deadline miss with SCHEDULER_MISS_LOG or SCHEDULER_MISS_ESCALATE,
+ * it does nothing unless the application provides its own to log the miss.
+ * 
+ * @param[in] task Task ID.
+ * @param[in] interval Time in ms since the previous periodic execution of the task.
+*/
+__weak void HIL_SCHEDULER_MissCallback( uint32_t task, uint32_t interval )
+{
+    ( void ) task;
+    ( void ) interval;
 }
 
 /**
- * @brief Function to make the Timer stop counting.
+ * @brief Function that executes a task and updates its execution time statistics.
  * 
  * @param[in] hscheduler
- * @param[in] Timer
+ * @param[in] task Index of the task in the TCB buffer.
 */
-uint8_t HIL_SCHEDULER_StopTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer )
+static void HIL_SCHEDULER_RunTask( Scheduler_HandleTypeDef *hscheduler, uint32_t task )
 {
-    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
-    
-    uint8_t SuccessFlag = 0;
-    
-    if ( ( Timer > ( uint32_t ) 0 ) && ( hscheduler->timers >= ( uint32_t ) 1 ) )
+#if SCHEDULER_PROFILER == 1
+    TaskStats_TypeDef *Stats = &hscheduler->taskPtr[task].stats;
+    uint32_t TickStart = HAL_GetTick();
+    uint16_t CountStart = ( uint16_t ) __HAL_TIM_GET_COUNTER( &TIM6_Handler );
+    uint32_t Time;
+
+    TASK_FUNC( hscheduler, task )();
+
+    Time = HIL_SCHEDULER_TimeSince( TickStart, CountStart );
+
+    if( Time < Stats->minTime )
     {
-        hscheduler->timerPtr[Timer - ( uint32_t ) 1].StartFlag = 0;
-        SuccessFlag = 1;
+        Stats->minTime = Time;
     }
-
-    return SuccessFlag;
-}
\ No newline at end of file
+    if( Time > Stats->maxTime )
+    {
+        Stats->maxTime = Time;
+    }
+    if( Time > ( TASK_PERIOD( hscheduler, task ) * 1000u ) )
+    {
+        Stats->overruns++;
+    }
+    Stats->totalTime += Time;
+    Stats->runs++;
+#else
+    TASK_FUNC( hscheduler, task )();
+#endif
+#if SCHEDULER_STACK_MONITOR == 1
+    HIL_SCHEDULER_CheckStack( hscheduler, &hscheduler->taskPtr[task].stackDepth );
+#endif
+}
+
+#if ( SCHEDULER_AUTO_PHASE == 1 ) && ( SCHEDULER_CYCLIC == 0 )
+/**
+ * @brief Function to give an offset to the tasks that don't have one.
+ * 
+ * The tasks are placed from the most to the least urgent after the ones with an offset already set.
+ * Two tasks run in the same tick at some point when their offsets are equal modulo the GCD of their
+ * periods, and the shorter the LCM of the periods the more often it happens. Every task takes the
+ * first offset with the fewest coincidences over time with the tasks already placed.
+ * 
+ * @param[in] hscheduler
+*/
+static void HIL_SCHEDULER_AssignPhases( Scheduler_HandleTypeDef *hscheduler )
+{
+    uint32_t Placed[TASKS_N] = {0};
+    uint32_t Task;
+    uint32_t Period;
+    uint32_t Gcd;
+    uint32_t Hits;
+    uint32_t BestHits;
+    uint32_t BestOffset;
+
+    for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
+    {
+        Placed[i] = ( hscheduler->taskPtr[i].offset != 0u ) ? 1u : 0u;
+    }
+
+    do
+    {
+        Task = hscheduler->tasksCount;
+        for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
+        {
+            if( ( Placed[i] == 0u ) && ( ( Task == hscheduler->tasksCount ) || ( hscheduler->taskPtr[i].priority < hscheduler->taskPtr[Task].priority ) ) )
+            {
+                Task = i;
+            }
+        }
+
+        if( Task < hscheduler->tasksCount )
+        {
+            Period = TASK_PERIOD( hscheduler, Task );
+            BestHits = 0xFFFFFFFFu;
+            BestOffset = 0;
+
+            for ( uint32_t Offset = 0; Offset < Period; Offset += hscheduler->tick )
+            {
+                Hits = 0;
+                for ( uint32_t j = 0; j < hscheduler->tasksCount; j++ )
+                {
+                    if( Placed[j] != 0u )
+                    {
+                        Gcd = HIL_SCHEDULER_Gcd( Period, TASK_PERIOD( hscheduler, j ) );
+                        if( ( Offset % Gcd ) == ( hscheduler->taskPtr[j].offset % Gcd ) )
+                        {
+                            /*Coincidences in 1000 s, 1000000 / LCM.*/
+                            Hits += ( Gcd * ( 1000000u / Period ) ) / TASK_PERIOD( hscheduler, j );
+                        }
+                    }
+                }
+
+                if( Hits < BestHits )
+                {
+                    BestHits = Hits;
+                    BestOffset = Offset;
+                }
+            }
+
+            hscheduler->taskPtr[Task].offset = BestOffset;
+            Placed[Task] = 1;
+        }
+    } while( Task < hscheduler->tasksCount );
+}
+
+/**
+ * @brief Function to calculate the greatest common divisor of two numbers.
+ * 
+ * @param[in] a
+ * @param[in] b
+ * @retval  The greatest common divisor.
+*/
+static uint32_t HIL_SCHEDULER_Gcd( uint32_t a, uint32_t b )
+{
+    uint32_t A = a;
+    uint32_t B = b;
+    uint32_t Rest;
+
+    while( B != 0u )
+    {
+        Rest = A % B;
+        A = B;
+        B = Rest;
+    }
+
+    return A;
+}
+#endif
+
+#if ( SCHEDULER_PROFILER == 1 ) || ( SCHEDULER_LOAD_METER == 1 )
+/**
+ * @brief Function to measure the time passed since a moment taken from the HAL tick and TIM6.
+ * 
+ * The time is read from the TIM6 1 us counter, times longer than its 16 bits range are taken
+ * from the ms tick instead.
+ * 
+ * @param[in] tickStart HAL tick at the start.
+ * @param[in] countStart TIM6 count at the start.
+ * @retval  The time passed in us.
+*/
+static uint32_t HIL_SCHEDULER_TimeSince( uint32_t tickStart, uint16_t countStart )
+{
+    uint32_t Time = ( uint16_t ) ( ( uint16_t ) __HAL_TIM_GET_COUNTER( &TIM6_Handler ) - countStart );
+
+    if( ( HAL_GetTick() - tickStart ) > 60u )
+    {
+        Time = ( HAL_GetTick() - tickStart ) * 1000u;
+    }
+
+    return Time;
+}
+#endif
+
+#if SCHEDULER_LOAD_METER == 1
+/**
+ * @brief Function to close the load measure of a tick.
+ * 
+ * The busy time of the tick is divided by the time since the previous tick, us over ms gives the
+ * load in per mille. Every second the load of the second is stored in the history.
+ * 
+ * @param[in] hscheduler
+ * @param[in] elapsed Time in ms since the previous tick.
+*/
+static void HIL_SCHEDULER_UpdateLoad( Scheduler_HandleTypeDef *hscheduler, uint32_t elapsed )
+{
+    uint32_t Load = hscheduler->tickBusy / elapsed;
+    uint32_t Time;
+
+    if( Load > 1000u )
+    {
+        Load = 1000;
+    }
+    if( Load > hscheduler->peakTick )
+    {
+        hscheduler->peakTick = Load;
+    }
+
+    hscheduler->secondBusy += hscheduler->tickBusy;
+    hscheduler->tickBusy = 0;
+
+    Time = HAL_GetTick() - hscheduler->secondStart;
+    if( Time >= 1000u )
+    {
+        Load = hscheduler->secondBusy / Time;
+        if( Load > 1000u )
+        {
+            Load = 1000;
+        }
+        hscheduler->loadHistory[hscheduler->loadIndex] = ( uint16_t ) Load;
+        hscheduler->loadIndex = ( hscheduler->loadIndex + 1u ) % 60u;
+        if( hscheduler->loadSeconds < 60u )
+        {
+            hscheduler->loadSeconds++;
+        }
+
+        hscheduler->secondBusy = 0;
+        hscheduler->secondStart += Time;
+    }
+}
+
+/**
+ * @brief Function to calculate the mean load of the last seconds stored in the history.
+ * 
+ * @param[in] hscheduler
+ * @param[in] seconds Number of seconds to average, less are taken if the history is not that long.
+ * @retval  The mean load in per mille.
+*/
+static uint32_t HIL_SCHEDULER_MeanLoad( Scheduler_HandleTypeDef *hscheduler, uint32_t seconds )
+{
+    uint32_t Sum = 0;
+    uint32_t Count = seconds;
+    uint32_t Index = hscheduler->loadIndex;
+
+    if( Count > hscheduler->loadSeconds )
+    {
+        Count = hscheduler->loadSeconds;
+    }
+
+    for ( uint32_t i = 0; i < Count; i++ )
+    {
+        Index = ( Index + 59u ) % 60u;
+        Sum += hscheduler->loadHistory[Index];
+    }
+
+    return ( Count != 0u ) ? ( Sum / Count ) : 0u;
+}
+#endif
+
+#if SCHEDULER_LOW_POWER == 1
+/**
+ * @brief Function to calculate the time left for the nearest task or timer deadline.
+ * 
+ * Stopped tasks and timers are not taken into account, the result is rounded up to whole ticks. It is
+ * taken again after every tick and after every pass for the notifications, which is also requested
+ * when a task or a timer is started.
+ * 
+ * @param[in] hscheduler
+ * @retval  The time in ms from the last tick to the nearest deadline, never less than one tick.
+*/
+static uint32_t HIL_SCHEDULER_NextDeadline( Scheduler_HandleTypeDef *hscheduler )
+{
+    uint32_t Deadline = 0xFFFFFFFFu;
+    uint32_t Remaining;
+
+#if SCHEDULER_CYCLIC == 1
+    /*Tasks left by the budget are due on the next tick, otherwise the next slot with tasks.*/
+    Remaining = ( hscheduler->due != 0u ) ? 0u : hscheduler->tick;
+    for ( uint32_t i = 1; ( hscheduler->due == 0u ) && ( i <= hscheduler->cyclicSlots ); i++ )
+    {
+        if( hscheduler->cyclicPtr[( hscheduler->cyclicCursor + i ) % hscheduler->cyclicSlots] != 0u )
+        {
+            Remaining = i * hscheduler->tick;
+            break;
+        }
+    }
+    Deadline = Remaining;
+#else
+    for ( uint32_t i = 0; i < hscheduler->tasksCount; i++ )
+    {
+        if( TASK_RUNNING( hscheduler, i ) )
+        {
+            Remaining = 0;
+            if( hscheduler->taskPtr[i].elapsed < TASK_PERIOD( hscheduler, i ) )
+            {
+                Remaining = TASK_PERIOD( hscheduler, i ) - hscheduler->taskPtr[i].elapsed;
+            }
+            if( Remaining < Deadline )
+            {
+                Deadline = Remaining;
+            }
+        }
+    }
+#endif
+
+    /*The first slot ahead with a timer in its last turn, a timer with turns left expires later than
+    a whole wheel turn, which is the time the wheel is advanced at most.*/
+    Remaining = 0;
+    for ( uint32_t i = 1; i <= ( uint32_t ) SCHEDULER_WHEEL_SLOTS; i++ )
+    {
+        for ( Timer_TypeDef *Timer = hscheduler->wheel[( hscheduler->wheelCursor + i ) & ( ( uint32_t ) SCHEDULER_WHEEL_SLOTS - 1u )]; Timer != NULL; Timer = Timer->next )
+        {
+            if( ( Remaining == 0u ) && ( Timer->Rounds == 0u ) )
+            {
+                Remaining = i;
+            }
+        }
+    }
+    if( ( hscheduler->timersCount != 0u ) && ( Remaining == 0u ) )
+    {
+        Remaining = SCHEDULER_WHEEL_SLOTS;
+    }
+    if( ( Remaining != 0u ) && ( ( Remaining * hscheduler->tick ) < Deadline ) )
+    {
+        Deadline = Remaining * hscheduler->tick;
+    }
+
+    if( ( Deadline < hscheduler->tick ) || ( Deadline == 0xFFFFFFFFu ) )
+    {
+        Deadline = hscheduler->tick;
+    }
+    else
+    {
+        Deadline = ( ( Deadline + hscheduler->tick - ( uint32_t ) 1 ) / hscheduler->tick ) * hscheduler->tick;
+    }
+
+    return Deadline;
+}
+#endif
+
+/**
+ * @brief Function to read the execution time statistics of a task.
+ * 
+ * The mean time is calculated from the accumulated time at the moment of the reading, the minimum
+ * time reads 0xFFFFFFFF while the task has not run.
+ * 
+ * @param[in] hscheduler
+ * @param[in] task
+ * @param[out] stats Structure where the statistics will be copied.
+ * @retval 	The function returns a flag: true if the statistics were read, false if the task does not exist
+ * or the profiler is disabled.
+*/
+uint8_t HIL_SCHEDULER_GetTaskStats( Scheduler_HandleTypeDef *hscheduler, uint32_t task, TaskStats_TypeDef *stats )
+{
+    uint8_t SuccessFlag = 0;
+
+    assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( hscheduler->tick != 0u ), SCHEDULER_PAR_ERROR );                  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( stats != NULL ), SCHEDULER_PAR_ERROR );                           /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+
+#if SCHEDULER_PROFILER == 1
+    if ( ( task > ( uint32_t ) 0 ) && ( task <= hscheduler->tasksCount ) )
+    {
+        *stats = hscheduler->taskPtr[task - ( uint32_t ) 1].stats;
+        stats->meanTime = 0;
+        if( stats->runs != 0u )
+        {
+            stats->meanTime = ( uint32_t ) ( stats->totalTime / stats->runs );
+        }
+        SuccessFlag = 1;
+    }
+#else
+    ( void ) task;
+#endif
+
+    return SuccessFlag;
+}
+
+/**
+ * @brief Function to read the jitter histogram and the deadline misses of a task.
+ * 
+ * @param[in] hscheduler
+ * @param[in] task
+ * @param[out] jitter Structure where the histogram will be copied.
+ * @retval 	The function returns a flag: true if the histogram was read, false if the task does not exist.
+*/
+uint8_t HIL_SCHEDULER_GetJitter( Scheduler_HandleTypeDef *hscheduler, uint32_t task, TaskJitter_TypeDef *jitter )
+{
+    uint8_t SuccessFlag = 0;
+
+    assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( hscheduler->tick != 0u ), SCHEDULER_PAR_ERROR );                  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( jitter != NULL ), SCHEDULER_PAR_ERROR );                          /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+
+    if ( ( task > ( uint32_t ) 0 ) && ( task <= hscheduler->tasksCount ) )
+    {
+        *jitter = hscheduler->taskPtr[task - ( uint32_t ) 1].jitter;
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+/**
+ * @brief Function to read the CPU load of the scheduler.
+ * 
+ * The load is the time spent running tasks and timers over the total time, in per mille, the rest
+ * is the idle time. Interrupts are counted as load only when they happen while a task runs. The
+ * averages are 0 until the first second is completed.
+ * 
+ * @param[in] hscheduler
+ * @param[out] load Structure where the load will be copied.
+ * @retval 	The function returns a flag: true if the load was read, false if the load meter is disabled.
+*/
+uint8_t HIL_SCHEDULER_GetLoad( Scheduler_HandleTypeDef *hscheduler, SchedulerLoad_TypeDef *load )
+{
+    uint8_t SuccessFlag = 0;
+
+    assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( hscheduler->tick != 0u ), SCHEDULER_PAR_ERROR );                  /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( load != NULL ), SCHEDULER_PAR_ERROR );                            /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+
+#if SCHEDULER_LOAD_METER == 1
+    load->load1s = HIL_SCHEDULER_MeanLoad( hscheduler, 1 );
+    load->load10s = HIL_SCHEDULER_MeanLoad( hscheduler, 10 );
+    load->load60s = HIL_SCHEDULER_MeanLoad( hscheduler, 60 );
+    load->peakTick = hscheduler->peakTick;
+    SuccessFlag = 1;
+#else
+    ( void ) load;
+#endif
+
+    return SuccessFlag;
+}
+
+/**
+ * @brief Function to read the stack use.
+ * 
+ * The stack of linker.ld is painted when the scheduler starts and the deepest word written is looked
+ * for after every task and every pass outside the tasks, then the words below the current stack
+ * pointer are painted again so the next measurement only takes what runs after. A peak equal to the
+ * size means the stack overflowed.
+ * 
+ * @param[in] hscheduler
+ * @param[out] stack Structure where the stack use will be copied.
+ * @retval 	The function returns a flag: true if the stack use was read, false if the monitor is disabled.
+*/
+uint8_t HIL_SCHEDULER_GetStack( Scheduler_HandleTypeDef *hscheduler, SchedulerStack_TypeDef *stack )
+{
+    uint8_t SuccessFlag = 0;
+
+    assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( ( stack != NULL ), SCHEDULER_PAR_ERROR );                           /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+
+#if SCHEDULER_STACK_MONITOR == 1
+    stack->size = ( uint32_t ) ( ( uint8_t * ) &_estack - ( uint8_t * ) &_sstack );
+    stack->peak = hscheduler->stackPeak;
+    stack->idle = hscheduler->stackIdle;
+    SuccessFlag = 1;
+#else
+    ( void ) stack;
+#endif
+
+    return SuccessFlag;
+}
+
+/**
+ * @brief Function to read the deepest stack use of a task.
+ * 
+ * The interrupts served while the task runs are taken as part of it.
+ * 
+ * @param[in] hscheduler
+ * @param[in] task
+ * @retval 	The deepest stack use in bytes, 0 if the task does not exist or the monitor is disabled.
+*/
+uint32_t HIL_SCHEDULER_GetTaskStack( Scheduler_HandleTypeDef *hscheduler, uint32_t task )
+{
+    uint32_t Depth = 0;
+
+    assert_error( ( hscheduler->tasks != 0u ), SCHEDULER_PAR_ERROR );                 /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+
+#if SCHEDULER_STACK_MONITOR == 1
+    if ( ( task > ( uint32_t ) 0 ) && ( task <= hscheduler->tasksCount ) )
+    {
+        Depth = hscheduler->taskPtr[task - ( uint32_t ) 1].stackDepth;
+    }
+#else
+    ( void ) task;
+#endif
+
+    return Depth;
+}
+
+/**
+ * @brief Function to register a new Timer.
+ * 
+ * The timer is registered stopped and in TIMER_ONE_SHOT mode.
+ * 
+ * @param[in] hscheduler
+ * @param[in] Timeout
+ * @param[in] CallbackPtr
+ * @retval 	The function returns the Timer ID, or 0 if the timeout is not valid or there is no room left.
+*/
+uint8_t HIL_SCHEDULER_RegisterTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timeout, void (*CallbackPtr)(void) )
+{
+    uint8_t TimerID = HIL_SCHEDULER_CreateTimer( hscheduler, Timeout, TIMER_ONE_SHOT, NULL, NULL );
+
+    if( TimerID != 0u )
+    {
+        hscheduler->timerPtr[TimerID - 1u].callbackPtr = CallbackPtr;
+    }
+
+    return TimerID;
+}
+
+/**
+ * @brief Function to register a new Timer with a context.
+ * 
+ * The timer is registered stopped, the callback gets the context every time the timer expires so a
+ * single function can serve the timers of several sessions. A TIMER_PERIODIC timer is reloaded with
+ * its timeout when it expires and keeps running until it is stopped.
+ * 
+ * @param[in] hscheduler
+ * @param[in] Timeout
+ * @param[in] Mode TIMER_ONE_SHOT or TIMER_PERIODIC.
+ * @param[in] CallbackPtr
+ * @param[in] Context User pointer passed to the callback.
+ * @retval 	The function returns the Timer ID, or 0 if the timeout or the mode are not valid or there is no room left.
+*/
+uint8_t HIL_SCHEDULER_CreateTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timeout, uint32_t Mode, void (*CallbackPtr)(void *context), void *Context )
+{
+    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    uint8_t TimerID = 0;
+    
+    if ( ( Timeout >= hscheduler->tick ) && ( ( Timeout % hscheduler->tick ) == ( uint32_t ) 0 ) && ( hscheduler->timersCount < hscheduler->timers ) &&
+         ( ( Mode == ( uint32_t ) TIMER_ONE_SHOT ) || ( Mode == ( uint32_t ) TIMER_PERIODIC ) ) ) {
+
+        hscheduler->timerPtr[hscheduler->timersCount].Timeout = Timeout;
+        hscheduler->timerPtr[hscheduler->timersCount].Count = 0;
+        hscheduler->timerPtr[hscheduler->timersCount].StartFlag = 0;
+        hscheduler->timerPtr[hscheduler->timersCount].Mode = Mode;
+        hscheduler->timerPtr[hscheduler->timersCount].Slot = TIMER_NO_SLOT;
+        hscheduler->timerPtr[hscheduler->timersCount].Rounds = 0;
+        hscheduler->timerPtr[hscheduler->timersCount].next = NULL;
+        hscheduler->timerPtr[hscheduler->timersCount].prev = NULL;
+        hscheduler->timerPtr[hscheduler->timersCount].callbackPtr = NULL;
+        hscheduler->timerPtr[hscheduler->timersCount].callbackCtxPtr = CallbackPtr;
+        hscheduler->timerPtr[hscheduler->timersCount].context = Context;
+
+        hscheduler->timersCount++;
+
+        TimerID = hscheduler->timersCount;
+    }
+
+    return TimerID;
+}
+
+/**
+ * @brief Function to change the context of a Timer.
+ * 
+ * The new context is passed to the callback from the next expiration, running or not.
+ * 
+ * @param[in] hscheduler
+ * @param[in] Timer
+ * @param[in] Context
+ * @retval 	The function returns a flag: true if the timer was changed successfully, and false if it wasn't.
+*/
+uint8_t HIL_SCHEDULER_ContextTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer, void *Context )
+{
+    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+
+    uint8_t SuccessFlag = 0;
+
+    if ( ( Timer > ( uint32_t ) 0 ) && ( Timer <= hscheduler->timersCount ) )
+    {
+        hscheduler->timerPtr[Timer - ( uint32_t ) 1].context = Context;
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+/**
+ * @brief Function to read the Timer count.
+ * 
+ * @param[in] hscheduler
+ * @param[in] Timer
+ * @retval 	The time in ms left for the timer to expire.
+*/
+uint32_t HIL_SCHEDULER_GetTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer )
+{
+    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    
+    uint32_t CounterReading = 0;
+    
+    if ( ( Timer > ( uint32_t ) 0 ) && ( Timer <= hscheduler->timersCount ) )
+    {
+        CounterReading = HIL_SCHEDULER_RemainingTimer( hscheduler, &hscheduler->timerPtr[Timer - ( uint32_t ) 1] );
+    }
+
+    return CounterReading;
+}
+
+/**
+ * @brief Function to set the Timer at it's maximum value.
+ *
+ * A running timer starts counting the new timeout from the current tick.
+ *
+ * @param[in] hscheduler
+ * @param[in] Timer
+ * @param[in] Timeout
+*/
+uint8_t HIL_SCHEDULER_ReloadTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer, uint32_t Timeout )
+{
+    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    
+    uint8_t SuccessFlag = 0;
+    Timer_TypeDef *TimerPtr;
+    
+    if ( ( Timer > ( uint32_t ) 0 ) &&  ( Timer <= hscheduler->timersCount ) )
+    {
+        TimerPtr = &hscheduler->timerPtr[Timer - ( uint32_t ) 1];
+        TimerPtr->Timeout = Timeout;
+        TimerPtr->Count = 0;
+
+        if( TimerPtr->Slot < ( uint32_t ) SCHEDULER_WHEEL_SLOTS )
+        {
+            HIL_SCHEDULER_UnlinkTimer( hscheduler, TimerPtr );
+            HIL_SCHEDULER_LinkTimer( hscheduler, TimerPtr, Timeout );
+        }
+        
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+/**
+ * @brief Function to make the Timer start counting.
+ * 
+ * A timer that was stopped before expiring resumes with the time it had left, otherwise it counts
+ * its whole timeout. Starting a running timer has no effect.
+ * 
+ * @param[in] hscheduler
+ * @param[in] Timer
+*/
+uint8_t HIL_SCHEDULER_StartTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer )
+{
+    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    
+    uint8_t SuccessFlag = 0;
+    Timer_TypeDef *TimerPtr;
+    
+    if ( ( Timer > ( uint32_t ) 0 ) && ( Timer <= hscheduler->timersCount ) )
+    {
+        TimerPtr = &hscheduler->timerPtr[Timer - ( uint32_t ) 1];
+
+        /*A timer expiring in the current tick is still in the expired list, it is not linked again.*/
+        if( ( TimerPtr->StartFlag == 0u ) && ( TimerPtr->Slot != TIMER_EXPIRED ) )
+        {
+            if( TimerPtr->Count != 0u )
+            {
+                HIL_SCHEDULER_LinkTimer( hscheduler, TimerPtr, TimerPtr->Count );
+            }
+            else
+            {
+                HIL_SCHEDULER_LinkTimer( hscheduler, TimerPtr, TimerPtr->Timeout );
+            }
+        }
+        TimerPtr->StartFlag = ( uint32_t ) 1;
+        /*The loop takes the deadline of the timer again before going to sleep.*/
+        hscheduler->pending = 1;
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+/**
+ * @brief Function to make the Timer stop counting.
+ * 
+ * The time left is kept, so the timer resumes from it when it is started again.
+ * 
+ * @param[in] hscheduler
+ * @param[in] Timer
+*/
+uint8_t HIL_SCHEDULER_StopTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer )
+{
+    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    
+    uint8_t SuccessFlag = 0;
+    Timer_TypeDef *TimerPtr;
+    
+    if ( ( Timer > ( uint32_t ) 0 ) && ( Timer <= hscheduler->timersCount ) )
+    {
+        TimerPtr = &hscheduler->timerPtr[Timer - ( uint32_t ) 1];
+
+        if( TimerPtr->StartFlag != 0u )
+        {
+            TimerPtr->Count = HIL_SCHEDULER_RemainingTimer( hscheduler, TimerPtr );
+            HIL_SCHEDULER_UnlinkTimer( hscheduler, TimerPtr );
+            TimerPtr->StartFlag = 0;
+        }
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+/**
+ * @brief Function to select if the Timer stops or reloads when it expires.
+ * 
+ * @param[in] hscheduler
+ * @param[in] Timer
+ * @param[in] Mode TIMER_ONE_SHOT or TIMER_PERIODIC
+*/
+uint8_t HIL_SCHEDULER_ModeTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer, uint32_t Mode )
+{
+    assert_error( hscheduler->tasks    != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->tick     != 0UL,  SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->taskPtr  != NULL, SCHEDULER_PAR_ERROR );             /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timers   != 0UL,  TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    assert_error( hscheduler->timerPtr != NULL, TIMER_PAR_ERROR );                 /* cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+    
+    uint8_t SuccessFlag = 0;
+    
+    if ( ( Timer > ( uint32_t ) 0 ) && ( Timer <= hscheduler->timersCount ) && ( ( Mode == ( uint32_t ) TIMER_ONE_SHOT ) || ( Mode == ( uint32_t ) TIMER_PERIODIC ) ) )
+    {
+        hscheduler->timerPtr[Timer - ( uint32_t ) 1].Mode = Mode;
+        SuccessFlag = 1;
+    }
+
+    return SuccessFlag;
+}
+
+/**
+ * @brief Function to link a timer in the wheel slot of its expiration tick.
+ * 
+ * The time is rounded up to whole ticks, the turns of the wheel above the first one are counted
+ * down in Rounds every time the cursor passes over the slot.
+ * 
+ * @param[in] hscheduler
+ * @param[in] timer
+ * @param[in] time Time in ms for the timer to expire.
+*/
+static void HIL_SCHEDULER_LinkTimer( Scheduler_HandleTypeDef *hscheduler, Timer_TypeDef *timer, uint32_t time )
+{
+    uint32_t Ticks = ( time + hscheduler->tick - ( uint32_t ) 1 ) / hscheduler->tick;
+
+    if( Ticks == 0u )
+    {
+        Ticks = 1;
+    }
+
+    timer->Slot = ( hscheduler->wheelCursor + Ticks ) & ( ( uint32_t ) SCHEDULER_WHEEL_SLOTS - 1u );
+    timer->Rounds = ( Ticks - ( uint32_t ) 1 ) / ( uint32_t ) SCHEDULER_WHEEL_SLOTS;
+    timer->prev = NULL;
+    timer->next = hscheduler->wheel[timer->Slot];
+
+    if( timer->next != NULL )
+    {
+        timer->next->prev = timer;
+    }
+    hscheduler->wheel[timer->Slot] = timer;
+}
+
+/**
+ * @brief Function to remove a timer from its wheel slot, if it is linked to one.
+ * 
+ * @param[in] hscheduler
+ * @param[in] timer
+*/
+static void HIL_SCHEDULER_UnlinkTimer( Scheduler_HandleTypeDef *hscheduler, Timer_TypeDef *timer )
+{
+    if( timer->Slot < ( uint32_t ) SCHEDULER_WHEEL_SLOTS )
+    {
+        if( timer->prev != NULL )
+        {
+            timer->prev->next = timer->next;
+        }
+        else
+        {
+            hscheduler->wheel[timer->Slot] = timer->next;
+        }
+
+        if( timer->next != NULL )
+        {
+            timer->next->prev = timer->prev;
+        }
+
+        timer->next = NULL;
+        timer->prev = NULL;
+        timer->Slot = TIMER_NO_SLOT;
+    }
+}
+
+/**
+ * @brief Function to calculate the time left for a timer to expire.
+ * 
+ * @param[in] hscheduler
+ * @param[in] timer
+ * @retval  The time in ms, the count kept by the timer if it is not running.
+*/
+static uint32_t HIL_SCHEDULER_RemainingTimer( Scheduler_HandleTypeDef *hscheduler, Timer_TypeDef *timer )
+{
+    uint32_t Remaining = timer->Count;
+    uint32_t Distance;
+
+    if( timer->Slot < ( uint32_t ) SCHEDULER_WHEEL_SLOTS )
+    {
+        Distance = ( timer->Slot - hscheduler->wheelCursor ) & ( ( uint32_t ) SCHEDULER_WHEEL_SLOTS - 1u );
+        if( Distance == 0u )
+        {
+            Distance = SCHEDULER_WHEEL_SLOTS;
+        }
+        Remaining = ( Distance + ( timer->Rounds * ( uint32_t ) SCHEDULER_WHEEL_SLOTS ) ) * hscheduler->tick;
+    }
+    else if( timer->Slot == TIMER_EXPIRED )
+    {
+        Remaining = 0;
+    }
+    else
+    {
+    }
+
+    return Remaining;
+}
+
+/**
+ * @brief Function to move the timers wheel a number of ticks and run the callbacks of the expired timers.
+ * 
+ * Only the timers linked in the slot of every tick are visited. The expired ones are taken out of
+ * the slot before any callback runs, so the callbacks are free to start, stop or reload any timer.
+ * 
+ * @param[in] hscheduler
+ * @param[in] ticks
+*/
+static void HIL_SCHEDULER_AdvanceTimers( Scheduler_HandleTypeDef *hscheduler, uint32_t ticks )
+{
+    Timer_TypeDef *Timer;
+    Timer_TypeDef *Next;
+    Timer_TypeDef *Expired;
+
+    for ( uint32_t t = 0; t < ticks; t++ )
+    {
+        hscheduler->wheelCursor = ( hscheduler->wheelCursor + ( uint32_t ) 1 ) & ( ( uint32_t ) SCHEDULER_WHEEL_SLOTS - 1u );
+        Expired = NULL;
+
+        Timer = hscheduler->wheel[hscheduler->wheelCursor];
+        while( Timer != NULL )
+        {
+            Next = Timer->next;
+            if( Timer->Rounds != 0u )
+            {
+                Timer->Rounds--;
+            }
+            else
+            {
+                HIL_SCHEDULER_UnlinkTimer( hscheduler, Timer );
+                Timer->Slot = TIMER_EXPIRED;
+                Timer->next = Expired;
+                Expired = Timer;
+            }
+            Timer = Next;
+        }
+
+        while( Expired != NULL )
+        {
+            Timer = Expired;
+            Expired = Timer->next;
+            Timer->next = NULL;
+            Timer->Slot = TIMER_NO_SLOT;
+            Timer->Count = 0;
+
+            /*A timer stopped by a previous callback does not run.*/
+            if( Timer->StartFlag != 0u )
+            {
+                if( Timer->Mode == ( uint32_t ) TIMER_PERIODIC )
+                {
+                    HIL_SCHEDULER_LinkTimer( hscheduler, Timer, Timer->Timeout );
+                }
+                else
+                {
+                    Timer->StartFlag = 0;
+                }
+
+                if( Timer->callbackPtr != NULL )
+                {
+                    Timer->callbackPtr();
+                }
+                if( Timer->callbackCtxPtr != NULL )
+                {
+                    Timer->callbackCtxPtr( Timer->context );
+                }
+            }
+        }
+    }
+}
+
+#if SCHEDULER_STACK_MONITOR == 1
+/**
+ * @brief Function to paint the free words of the stack.
+ * 
+ * The words from depth bytes below the top of the stack up to the current stack pointer are painted,
+ * with the interrupts masked so none of them uses the words while they are written.
+ * 
+ * @param[in] depth Deepest use in bytes of the last measurement, the words above are already painted.
+*/
+static void HIL_SCHEDULER_PaintStack( uint32_t depth )
+{
+    /*cppcheck-suppress misra-c2012-11.4 ; The stack is addressed as words.*/
+    uint32_t *Word = ( uint32_t * ) ( ( uint8_t * ) &_estack - depth );
+    uint32_t *Top;
+
+    __disable_irq();
+    /*cppcheck-suppress misra-c2012-11.4 ; The stack pointer is an address.*/
+    Top = ( uint32_t * ) ( uintptr_t ) __get_MSP();
+    /*cppcheck-suppress misra-c2012-18.3 ; Both point into the stack.*/
+    while( Word < Top )
+    {
+        *Word = STACK_PAINT;
+        Word++;
+    }
+    __enable_irq();
+}
+
+/**
+ * @brief Function to measure the stack use since the last measurement.
+ * 
+ * The first word not painted from the bottom of the stack is the deepest one written, the result goes
+ * to depth and to the peak when it is larger, and the stack is painted again. The bottom word written
+ * means the stack overflowed into the RAM below it.
+ * 
+ * @param[in] hscheduler
+ * @param[in,out] depth Deepest use in bytes to update.
+*/
+static void HIL_SCHEDULER_CheckStack( Scheduler_HandleTypeDef *hscheduler, uint32_t *depth )
+{
+    uint32_t *Word = &_sstack;
+    uint32_t Depth;
+
+    /*cppcheck-suppress misra-c2012-18.3 ; Both point into the stack.*/
+    while( ( Word < &_estack ) && ( *Word == STACK_PAINT ) )
+    {
+        Word++;
+    }
+    Depth = ( uint32_t ) ( ( uint8_t * ) &_estack - ( uint8_t * ) Word );
+
+    if( Depth > *depth )
+    {
+        *depth = Depth;
+    }
+    if( Depth > hscheduler->stackPeak )
+    {
+        hscheduler->stackPeak = Depth;
+    }
+
+    assert_error( ( Word != &_sstack ), SCHEDULER_STACK_ERROR );                    /*cppcheck-suppress misra-c2012-11.8 ; Function can't be modified.*/
+
+    HIL_SCHEDULER_PaintStack( Depth );
+}
+#endif
@@ -8,27 +8,166 @@
 
 #include "app_bsp.h"
 
+/** 
+ * @defgroup <Software timer modes.>
+ @{ */
+#define TIMER_ONE_SHOT      0   /*!< The timer stops when it expires.*/
+#define TIMER_PERIODIC      1   /*!< The timer is reloaded with its timeout every time it expires.*/
+/**
+ @} */
+
+/** 
+ * @defgroup <Actions on a deadline miss, for SCHEDULER_MISS_ACTION.>
+ @{ */
+#define SCHEDULER_MISS_COUNT        0   /*!< The miss is only counted.*/
+#define SCHEDULER_MISS_LOG          1   /*!< The miss is counted and HIL_SCHEDULER_MissCallback is called.*/
+#define SCHEDULER_MISS_ESCALATE     2   /*!< Like SCHEDULER_MISS_LOG, SCHEDULER_MISS_LIMIT misses in a row go to the safe state.*/
+/**
+ @} */
+
 /**
  * @brief Structure with the elements of the Software Timer.
 */
 typedef struct _Timer_TypeDef
 {
     uint32_t Timeout;           /*!< timer timeout to decrement and reload when the timer is re-started */
-    uint32_t Count;             /*!< actual timer decrement count */
+    uint32_t Count;             /*!< time left when the timer was stopped, 0 to start over from the timeout */
     uint32_t StartFlag;         /*!< flag to start timer count */
+    uint32_t Mode;              /*!< TIMER_ONE_SHOT or TIMER_PERIODIC */
+    uint32_t Slot;              /*!< wheel slot where the timer is linked */
+    uint32_t Rounds;            /*!< wheel turns left before the timer expires */
+    struct _Timer_TypeDef *next;    /*!< next timer linked in the same wheel slot */
+    struct _Timer_TypeDef *prev;    /*!< previous timer linked in the same wheel slot */
     void(*callbackPtr)(void);   /*!< pointer to callback function function */
+    void(*callbackCtxPtr)(void *context);  /*!< pointer to callback function that takes the context */
+    void *context;              /*!< user pointer passed to callbackCtxPtr, like the session the timer belongs to */
 } Timer_TypeDef;
 
+/**
+ * @brief Structure with a callback queued by an interrupt to run in the scheduler loop.
+*/
+typedef struct _Deferred_TypeDef
+{
+    void(*callbackPtr)(void *context);  /*!< pointer to callback function */
+    void *context;                      /*!< user pointer passed to the callback */
+} Deferred_TypeDef;
+
+/**
+ * @brief Structure with the execution time statistics of a task, times are in us.
+*/
+typedef struct _TaskStats_TypeDef
+{
+    uint32_t minTime;       /*!<Shortest execution time.*/
+    uint32_t maxTime;       /*!<Longest execution time.*/
+    uint32_t meanTime;      /*!<Mean execution time, calculated by HIL_SCHEDULER_GetTaskStats.*/
+    uint32_t runs;          /*!<Number of times the task has been executed.*/
+    uint32_t overruns;      /*!<Number of executions that took longer than the task period.*/
+    uint64_t totalTime;     /*!<Sum of all the execution times.*/
+} TaskStats_TypeDef;
+
+/**
+ * @brief Structure with the jitter of the periodic executions of a task, times are in ms.
+*/
+typedef struct _TaskJitter_TypeDef
+{
+    uint32_t bins[SCHEDULER_JITTER_BINS]; /*!<Executions by deviation from the period: 0, 1, 2-3, 4-7 ms and so on.*/
+    uint32_t maxDeviation;  /*!<Largest deviation from the period.*/
+    uint32_t misses;        /*!<Executions that deviated more than SCHEDULER_MISS_TOLERANCE.*/
+    uint32_t missRun;       /*!<Misses in a row up to the last execution.*/
+} TaskJitter_TypeDef;
+
+/**
+ * @brief Structure with the stack use measured by painting, sizes are in bytes.
+*/
+typedef struct _SchedulerStack_TypeDef
+{
+    uint32_t size;          /*!<Size of the stack reserved in linker.ld.*/
+    uint32_t peak;          /*!<Deepest use since the start, init functions included.*/
+    uint32_t idle;          /*!<Deepest use outside the tasks: interrupts while idle, timer and deferred callbacks.*/
+} SchedulerStack_TypeDef;
+
+/**
+ * @brief Structure with the CPU load of the scheduler, the loads are in per mille of the time.
+*/
+typedef struct _SchedulerLoad_TypeDef
+{
+    uint32_t load1s;        /*!<Load of the last second.*/
+    uint32_t load10s;       /*!<Mean load of the last 10 seconds.*/
+    uint32_t load60s;       /*!<Mean load of the last 60 seconds.*/
+    uint32_t peakTick;      /*!<Highest load of a single tick since the scheduler started.*/
+} SchedulerLoad_TypeDef;
+
+/**
+ * @brief Structure with the configuration of a task in the static task table.
+*/
+typedef struct _TaskConfig_TypeDef
+{
+    uint32_t period;          /*!<How often the task should run in ms.*/
+    uint32_t offset;          /*!<Time in ms from the start to the first execution, 0 to wait a whole period.*/
+    void (*initFunc)(void);   /*!<Pointer to init task function.*/
+    void (*taskFunc)(void);   /*!<Pointer to task function.*/
+} TaskConfig_TypeDef;
+
+/**
+ * @brief Macro to evaluate the period of a task only if it is a multiple of TICK_VAL, otherwise the
+ * array size is negative and the build fails.
+*/
+#define SCHEDULER_CHECK_PERIOD( period )    ( ( period ) + ( 0u * sizeof( char[ ( ( ( period ) >= TICK_VAL ) && ( ( ( period ) % TICK_VAL ) == 0 ) ) ? 1 : -1 ] ) ) )
+
+/**
+ * @brief Macro to evaluate the offset of a task only if it is a multiple of TICK_VAL shorter than the
+ * period, otherwise the array size is negative and the build fails.
+*/
+#define SCHEDULER_CHECK_OFFSET( period, offset )    ( ( offset ) + ( 0u * sizeof( char[ ( ( ( offset ) < ( period ) ) && ( ( ( offset ) % TICK_VAL ) == 0 ) ) ? 1 : -1 ] ) ) )
+
+/**
+ * @brief Macro to declare an element of the static task table, the period is checked at build time.
+*/
+#define SCHEDULER_TASK( init, task, period )    SCHEDULER_TASK_OFFSET( init, task, period, 0 )
+
+/**
+ * @brief Macro to declare an element of the static task table that first runs offset ms after the
+ * start, the period and the offset are checked at build time.
+*/
+#define SCHEDULER_TASK_OFFSET( init, task, period, offset )    { SCHEDULER_CHECK_PERIOD( period ), SCHEDULER_CHECK_OFFSET( period, offset ), ( init ), ( task ) }
+
+/**
+ * @brief Macros to expand a task list written as X-macro, SCHEDULER_TASK_LIST( TASK, arg ) calls
+ * TASK( arg, init, task, period, offset ) once per task, ENTRY declares the elements of the static
+ * task table and INDEX the enumerator SCHEDULER_INDEX_<task> with the position of the task in it.
+*/
+#define SCHEDULER_TASK_ENTRY( arg, init, task, period, offset )    SCHEDULER_TASK_OFFSET( init, task, period, offset ),
+#define SCHEDULER_TASK_INDEX( arg, init, task, period, offset )    SCHEDULER_INDEX_##task,
+
 /**
  * @brief Structure with the TCB elements.
 */
 typedef struct _task
 {
+#if SCHEDULER_STATIC_TASKS == 1
+    uint32_t elapsed;         /*!<The cuurent elapsed time.*/
+    uint32_t stopped;         /*!<Flag set while the task is stopped.*/
+#else
     uint32_t period;          /*!<How often the task shopud run in ms.*/
     uint32_t elapsed;         /*!<The cuurent elapsed time.*/
     void (*initFunc)(void);   /*!<Pointer to init task function.*/
     void (*taskFunc)(void);   /*!<Pointer to task function.*/
     void (*taskFunc1)(void); /*!<Pointer to task function auxiliary.*/
+#endif
+    uint32_t priority;        /*!<Task priority, the lower the value the sooner it runs when several are due.*/
+    uint32_t offset;          /*!<Time in ms from the start to the first execution, 0 to wait a whole period.*/
+    uint32_t lastRun;         /*!<HAL tick of the last periodic execution, 0 before the first one.*/
+    TaskJitter_TypeDef jitter; /*!<Jitter histogram and deadline misses.*/
+    volatile uint32_t ready;  /*!<Flag set by HIL_SCHEDULER_Notify to run the task on the next loop pass.*/
+#if SCHEDULER_TICK_BUDGET > 0
+    uint32_t deferrals;       /*!<Ticks in a row the task was left due by the budget, it runs before the ones left fewer times.*/
+#endif
+#if SCHEDULER_PROFILER == 1
+    TaskStats_TypeDef stats;  /*!<Execution time statistics.*/
+#endif
+#if SCHEDULER_STACK_MONITOR == 1
+    uint32_t stackDepth;      /*!<Deepest stack use in bytes of the task and the interrupts it was hit by.*/
+#endif
 } Task_TypeDef;
 
 /**
@@ -40,8 +179,38 @@ typedef struct _scheduler
     uint32_t tick;          /*!<the time base in ms*/
     uint32_t tasksCount;    /*!<internal task counter*/
     Task_TypeDef *taskPtr;  /*!<Pointer to buffer for the TCB tasks*/
+#if SCHEDULER_STATIC_TASKS == 1
+    const TaskConfig_TypeDef *configPtr; /*!<Pointer to the static task table*/
+#endif
+#if SCHEDULER_CYCLIC == 1
+    const uint32_t *cyclicPtr; /*!<Pointer to the cyclic executive table, a mask of the due tasks per tick*/
+    uint32_t cyclicSlots;   /*!<ticks of the hyperperiod, elements of the cyclic executive table*/
+    uint32_t cyclicCursor;  /*!<slot of the cyclic executive table of the current tick*/
+    uint32_t due;           /*!<mask of the tasks due and not run yet*/
+#endif
     uint32_t timers;         /*!<number of software timer to use*/
+    uint32_t timersCount;    /*!<internal timer counter*/
     Timer_TypeDef *timerPtr; /*!<Pointer to buffer timer array*/
+    uint32_t wheelCursor;    /*!<wheel slot of the current tick*/
+    Timer_TypeDef *wheel[SCHEDULER_WHEEL_SLOTS]; /*!<lists of the running timers, hashed by expiration tick*/
+    volatile uint32_t pending; /*!<flag set when a task has been notified or a task or timer started*/
+#if SCHEDULER_DEFER_N > 0
+    QUEUE_HandleTypeDef deferQueue; /*!<queue of the callbacks deferred by the interrupts*/
+    Deferred_TypeDef deferBuffer[SCHEDULER_DEFER_N]; /*!<buffer of the deferred callbacks queue*/
+#endif
+#if SCHEDULER_LOAD_METER == 1
+    uint32_t tickBusy;      /*!<time in us running tasks and timers since the last tick*/
+    uint32_t secondBusy;    /*!<time in us running tasks and timers in the current second*/
+    uint32_t secondStart;   /*!<HAL tick when the current second started*/
+    uint32_t peakTick;      /*!<highest load of a single tick in per mille*/
+    uint32_t loadIndex;     /*!<next element of the load history to write*/
+    uint32_t loadSeconds;   /*!<seconds stored in the load history, up to 60*/
+    uint16_t loadHistory[60]; /*!<load in per mille of each of the last seconds*/
+#endif
+#if SCHEDULER_STACK_MONITOR == 1
+    uint32_t stackPeak;     /*!<deepest stack use in bytes since the start*/
+    uint32_t stackIdle;     /*!<deepest stack use in bytes outside the tasks*/
+#endif
 } Scheduler_HandleTypeDef;
 
 /**
@@ -50,11 +219,13 @@ typedef struct _scheduler
 */
 void HIL_SCHEDULER_Init( Scheduler_HandleTypeDef *hscheduler );
 
+#if SCHEDULER_STATIC_TASKS == 0
 /**
  * @brief Function to register the tasks 
  * Function to add the task to bufer
 */
 uint8_t HIL_SCHEDULER_RegisterTask( Scheduler_HandleTypeDef *hscheduler, void (*InitPtr)(void), void (*TaskPtr)(void), uint32_t Period );
+#endif
 
 /**
  * @brief Function to stop the tasks 
@@ -68,11 +239,69 @@ uint8_t HIL_SCHEDULER_StopTask( Scheduler_HandleTypeDef *hscheduler, uint32_t ta
 */
 uint8_t HIL_SCHEDULER_StartTask( Scheduler_HandleTypeDef *hscheduler, uint32_t task );
 
+#if SCHEDULER_STATIC_TASKS == 0
 /**
  * @brief Function to change the period
  * Function to add new period
 */
 uint8_t HIL_SCHEDULER_PeriodTask( Scheduler_HandleTypeDef *hscheduler, uint32_t task, uint32_t period );
+#endif
+
+/**
+ * @brief Function to change the priority
+ * Function to set which task runs first when several are due in the same tick
+*/
+uint8_t HIL_SCHEDULER_PriorityTask( Scheduler_HandleTypeDef *hscheduler, uint32_t task, uint32_t priority );
+
+#if SCHEDULER_CYCLIC == 0
+/**
+ * @brief Function to change the offset
+ * Function to set when the task runs for the first time, to stagger the tasks with related periods
+*/
+uint8_t HIL_SCHEDULER_OffsetTask( Scheduler_HandleTypeDef *hscheduler, uint32_t task, uint32_t offset );
+#endif
+
+/**
+ * @brief Function to mark a task as ready from an interrupt
+ * The task runs on the next loop pass, without waiting for its period
+*/
+uint8_t HIL_SCHEDULER_Notify( Scheduler_HandleTypeDef *hscheduler, uint32_t task );
+
+/**
+ * @brief Function to read the execution time statistics of a task.
+ * 
+*/
+uint8_t HIL_SCHEDULER_GetTaskStats( Scheduler_HandleTypeDef *hscheduler, uint32_t task, TaskStats_TypeDef *stats );
+
+/**
+ * @brief Function to read the jitter histogram and the deadline misses of a task.
+ * 
+*/
+uint8_t HIL_SCHEDULER_GetJitter( Scheduler_HandleTypeDef *hscheduler, uint32_t task, TaskJitter_TypeDef *jitter );
+
+/**
+ * @brief Function called on a deadline miss, defined weak to be replaced by the application.
+ * 
+*/
+void HIL_SCHEDULER_MissCallback( uint32_t task, uint32_t interval );
+
+/**
+ * @brief Function to read the CPU load of the scheduler.
+ * 
+*/
+uint8_t HIL_SCHEDULER_GetLoad( Scheduler_HandleTypeDef *hscheduler, SchedulerLoad_TypeDef *load );
+
+/**
+ * @brief Function to read the stack use.
+ * 
+*/
+uint8_t HIL_SCHEDULER_GetStack( Scheduler_HandleTypeDef *hscheduler, SchedulerStack_TypeDef *stack );
+
+/**
+ * @brief Function to read the deepest stack use of a task.
+ * 
+*/
+uint32_t HIL_SCHEDULER_GetTaskStack( Scheduler_HandleTypeDef *hscheduler, uint32_t task );
 
 /**
  * @brief Function to run all task
@@ -86,6 +315,18 @@ void HIL_SCHEDULER_Start( Scheduler_HandleTypeDef *hscheduler );
 */
 uint8_t HIL_SCHEDULER_RegisterTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timeout, void (*CallbackPtr)(void) );
 
+/**
+ * @brief Function to register a new Timer with a context.
+ * Function to register a timer whose callback gets a user pointer, in the mode given
+*/
+uint8_t HIL_SCHEDULER_CreateTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timeout, uint32_t Mode, void (*CallbackPtr)(void *context), void *Context );
+
+/**
+ * @brief Function to change the context of a Timer.
+ * 
+*/
+uint8_t HIL_SCHEDULER_ContextTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer, void *Context );
+
 /**
  * @brief Function to read the Timer count.
  * 
@@ -110,4 +351,18 @@ uint8_t HIL_SCHEDULER_StartTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t
 */
 uint8_t HIL_SCHEDULER_StopTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer );
 
+/**
+ * @brief Function to select if the Timer stops or reloads when it expires.
+ * 
+*/
+uint8_t HIL_SCHEDULER_ModeTimer( Scheduler_HandleTypeDef *hscheduler, uint32_t Timer, uint32_t Mode );
+
+#if SCHEDULER_DEFER_N > 0
+/**
+ * @brief Function to run a callback in the scheduler loop.
+ * Function meant to be called from an interrupt to move work out of it
+*/
+uint8_t HIL_SCHEDULER_Defer( Scheduler_HandleTypeDef *hscheduler, void (*CallbackPtr)(void *context), void *Context );
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,113 @@
+/**
+ * @file    scheduler_cyclic.h
+ * @brief   **This file generates the cyclic executive table of the static task list.**
+ *
+ * The schedule of a task set with periods multiple of TICK_VAL repeats every hyperperiod, so the
+ * tasks due on every tick can be worked out by the preprocessor. The table holds one mask per tick of
+ * the hyperperiod with the bit of every task due on it, the scheduler walks it with a cursor and
+ * does not keep the elapsed time of each task.
+ *
+ * It must be included once, by the file that defines SCHEDULER_TASK_LIST and the enumeration
+ * built with SCHEDULER_TASK_INDEX, the table is handed to the scheduler with the fields cyclicPtr and
+ * cyclicSlots. Slot k is the tick k * TICK_VAL ms after the start, a task runs on the ticks where the
+ * time modulo its period matches its offset, the slot 0 being the end of the hyperperiod.
+ */
+
+#ifndef SCHEDULER_CYCLIC_H
+#define SCHEDULER_CYCLIC_H
+
+    #include "app_bsp.h"
+
+#ifndef SCHEDULER_TASK_LIST
+#error "SCHEDULER_TASK_LIST must be defined before including scheduler_cyclic.h"
+#endif
+
+#if ( SCHEDULER_HYPERPERIOD % TICK_VAL ) != 0
+#error "SCHEDULER_HYPERPERIOD must be a multiple of TICK_VAL"
+#endif
+
+    /**
+     * @brief Ticks of the hyperperiod, elements of the table.
+    */
+    #define SCHEDULER_CYCLIC_SLOTS              ( SCHEDULER_HYPERPERIOD / TICK_VAL )
+
+#if ( SCHEDULER_CYCLIC_SLOTS == 0 ) || ( SCHEDULER_CYCLIC_SLOTS > 511 )
+#error "The hyperperiod must have between 1 and 511 ticks"
+#endif
+
+#if TASKS_N > 32
+#error "The cyclic executive masks hold up to 32 tasks"
+#endif
+
+    /**
+     * @brief Macro that adds one when the period of a task does not divide the hyperperiod.
+    */
+    #define SCHEDULER_CYCLIC_CHECK( arg, init, task, period, offset )   + ( ( ( SCHEDULER_HYPERPERIOD % ( period ) ) != 0 ) ? 1 : 0 )
+
+    /*The build fails if the period of a task does not divide the hyperperiod.*/
+    /*cppcheck-suppress misra-c2012-2.3 ; Type used only to check the hyperperiod.*/
+    typedef char SchedulerCyclicCheck[ ( ( 0 SCHEDULER_TASK_LIST( SCHEDULER_CYCLIC_CHECK, 0 ) ) == 0 ) ? 1 : -1 ];
+
+    /**
+     * @brief Macro with the bit of a task if it is due on the slot k.
+    */
+    #define SCHEDULER_CYCLIC_BIT( k, init, task, period, offset )                                        \
+        | ( ( ( ( ( k ) * TICK_VAL ) % ( period ) ) == ( ( offset ) % ( period ) ) ) ? ( ( uint32_t ) 1 << SCHEDULER_INDEX_##task ) : 0u )
+
+    /**
+     * @brief Macro with the element of the table of the slot k.
+    */
+    #define SCHEDULER_CYCLIC_SLOT( k )          ( 0u SCHEDULER_TASK_LIST( SCHEDULER_CYCLIC_BIT, k ) ),
+
+    /**
+     * @defgroup <Macros to call M( base ), M( base + 1 ) ... with a power of two number of slots.>
+     *
+     @{ */
+    #define SCHEDULER_REPEAT_1( M, b )          M( b )
+    #define SCHEDULER_REPEAT_2( M, b )          SCHEDULER_REPEAT_1( M, b ) SCHEDULER_REPEAT_1( M, ( b ) + 1 )
+    #define SCHEDULER_REPEAT_4( M, b )          SCHEDULER_REPEAT_2( M, b ) SCHEDULER_REPEAT_2( M, ( b ) + 2 )
+    #define SCHEDULER_REPEAT_8( M, b )          SCHEDULER_REPEAT_4( M, b ) SCHEDULER_REPEAT_4( M, ( b ) + 4 )
+    #define SCHEDULER_REPEAT_16( M, b )         SCHEDULER_REPEAT_8( M, b ) SCHEDULER_REPEAT_8( M, ( b ) + 8 )
+    #define SCHEDULER_REPEAT_32( M, b )         SCHEDULER_REPEAT_16( M, b ) SCHEDULER_REPEAT_16( M, ( b ) + 16 )
+    #define SCHEDULER_REPEAT_64( M, b )         SCHEDULER_REPEAT_32( M, b ) SCHEDULER_REPEAT_32( M, ( b ) + 32 )
+    #define SCHEDULER_REPEAT_128( M, b )        SCHEDULER_REPEAT_64( M, b ) SCHEDULER_REPEAT_64( M, ( b ) + 64 )
+    #define SCHEDULER_REPEAT_256( M, b )        SCHEDULER_REPEAT_128( M, b ) SCHEDULER_REPEAT_128( M, ( b ) + 128 )
+    /**
+     @} */
+
+    /**
+     * @brief Cyclic executive table, the slots are generated by blocks following the bits of the
+     * number of slots, from the highest one.
+    */
+    static const uint32_t SchedulerCyclicTable[ SCHEDULER_CYCLIC_SLOTS ] =
+    {
+#if ( SCHEDULER_CYCLIC_SLOTS & 256 ) != 0
+        SCHEDULER_REPEAT_256( SCHEDULER_CYCLIC_SLOT, 0 )
+#endif
+#if ( SCHEDULER_CYCLIC_SLOTS & 128 ) != 0
+        SCHEDULER_REPEAT_128( SCHEDULER_CYCLIC_SLOT, ( SCHEDULER_CYCLIC_SLOTS & 256 ) )
+#endif
+#if ( SCHEDULER_CYCLIC_SLOTS & 64 ) != 0
+        SCHEDULER_REPEAT_64( SCHEDULER_CYCLIC_SLOT, ( SCHEDULER_CYCLIC_SLOTS & 384 ) )
+#endif
+#if ( SCHEDULER_CYCLIC_SLOTS & 32 ) != 0
+        SCHEDULER_REPEAT_32( SCHEDULER_CYCLIC_SLOT, ( SCHEDULER_CYCLIC_SLOTS & 448 ) )
+#endif
+#if ( SCHEDULER_CYCLIC_SLOTS & 16 ) != 0
+        SCHEDULER_REPEAT_16( SCHEDULER_CYCLIC_SLOT, ( SCHEDULER_CYCLIC_SLOTS & 480 ) )
+#endif
+#if ( SCHEDULER_CYCLIC_SLOTS & 8 ) != 0
+        SCHEDULER_REPEAT_8( SCHEDULER_CYCLIC_SLOT, ( SCHEDULER_CYCLIC_SLOTS & 496 ) )
+#endif
+#if ( SCHEDULER_CYCLIC_SLOTS & 4 ) != 0
+        SCHEDULER_REPEAT_4( SCHEDULER_CYCLIC_SLOT, ( SCHEDULER_CYCLIC_SLOTS & 504 ) )
+#endif
+#if ( SCHEDULER_CYCLIC_SLOTS & 2 ) != 0
+        SCHEDULER_REPEAT_2( SCHEDULER_CYCLIC_SLOT, ( SCHEDULER_CYCLIC_SLOTS & 508 ) )
+#endif
+#if ( SCHEDULER_CYCLIC_SLOTS & 1 ) != 0
+        SCHEDULER_REPEAT_1( SCHEDULER_CYCLIC_SLOT, ( SCHEDULER_CYCLIC_SLOTS & 510 ) )
+#endif
+    };
+
+#endif
@@ -0,0 +1,414 @@
+/**
+ * @file    bench_queue.c
+ * @brief   **Micro-benchmark of the queue functions on the host and on the board.**
+ *
+ * Every queue function is timed filling and emptying queues of several element sizes and capacities,
+ * the time of a batch of calls is divided by the number of calls, so the numbers include the loop
+ * that makes the calls. The three ways to wrap an index around the end of the buffer are timed the
+ * same way: the remainder used by HIL_QUEUE_Write and HIL_QUEUE_Read, the mask of the SPSC functions
+ * and the compare used by the typed queues.
+ *
+ * On the host the time is read with clock_gettime and printed in ns, the interrupts are not masked so
+ * the ISR functions only add the cost of the calls. On the board TIM6 counts the core clock and the
+ * results are printed in cycles over the semihosting, they need a debugger connected with semihosting
+ * enabled (make open, then "monitor arm semihosting enable" from make debug).
+ *
+ * Usage: make bench-host, or make bench and load Build/bench.elf on the board.
+ */
+
+#if defined( BENCH_HOST )
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif
+
+#include "app_bsp.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @defgroup <Benchmark settings.>
+ @{ */
+#define BENCH_REPS          64u     /*!< Times every queue is filled and emptied.*/
+#define BENCH_BATCH         8u      /*!< Calls timed together, they have to fit in the 16 bits of TIM6.*/
+#define BENCH_WRAP_N        512u    /*!< Index increments timed by every wrap test.*/
+#define BENCH_MAX_SIZE      48u     /*!< Largest element size.*/
+#define BENCH_MAX_ELEMENTS  64u     /*!< Largest capacity.*/
+/**
+ @} */
+
+/**
+ * @brief   Queue functions and wrap methods to time.
+ */
+typedef enum
+{
+    BENCH_NONE,
+    BENCH_WRITE,
+    BENCH_READ,
+    BENCH_WRITE_ISR,
+    BENCH_READ_ISR,
+    BENCH_WRITE_SPSC,
+    BENCH_READ_SPSC,
+    BENCH_WRAP_MOD,
+    BENCH_WRAP_MASK,
+    BENCH_WRAP_CMP
+} BENCH_OpTypeDef;
+
+/**
+ * @brief   Names of the operations to print, in the order of BENCH_OpTypeDef.
+ */
+static const char * const BenchNames[] =
+{
+    "none", "Write", "Read", "WriteISR", "ReadISR", "WriteSPSC", "ReadSPSC", "wrap %", "wrap &", "wrap ?:"
+};
+
+/**
+ * @brief   Element sizes in bytes, the 8 bytes of a CAN frame and the 48 of APP_MsgTypeDef.
+ */
+static const uint8_t BenchSizes[] = { 1u, 4u, 8u, BENCH_MAX_SIZE };
+
+/**
+ * @brief   Capacities, the powers of two are also timed with the SPSC functions.
+ */
+static const uint32_t BenchElements[] = { 16u, 45u, BENCH_MAX_ELEMENTS };
+
+static uint8_t BenchBuffer[ BENCH_MAX_SIZE * BENCH_MAX_ELEMENTS ];
+static uint8_t BenchData[ BENCH_MAX_SIZE ];
+static QUEUE_HandleTypeDef BenchQueue;
+
+/*Read through a volatile so the compiler can not turn the remainder into a mask.*/
+static volatile uint32_t BenchWrapElements = 16u;
+static volatile uint32_t BenchIndex;
+
+static uint32_t BenchOverhead = 0;
+
+static uint32_t Bench_Now( void );
+static uint32_t Bench_Elapsed( uint32_t start );
+static uint32_t Bench_Batch( BENCH_OpTypeDef op, uint32_t n );
+static uint32_t Bench_Net( uint32_t time );
+static void Bench_Print( uint32_t time );
+static void Bench_Row( const char *name, uint8_t size, uint32_t elements, uint32_t writeTime, uint32_t readTime );
+static uint32_t Bench_Queue( BENCH_OpTypeDef write, BENCH_OpTypeDef read, uint8_t size, uint32_t elements, uint32_t *readTime );
+static uint32_t Bench_Wrap( BENCH_OpTypeDef op );
+static void Bench_Init( void );
+
+#if defined( BENCH_HOST )
+
+/**
+ * @brief   Unit of the printed results.
+ */
+#define BENCH_UNIT          "ns"
+
+/**
+ * @brief   Host clock in ns, only the difference between two readings is used.
+ */
+static uint32_t Bench_Now( void )
+{
+    struct timespec Time;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &Time );
+
+    return ( uint32_t ) ( ( ( uint64_t ) Time.tv_sec * 1000000000u ) + ( uint64_t ) Time.tv_nsec );
+}
+
+static uint32_t Bench_Elapsed( uint32_t start )
+{
+    return Bench_Now() - start;
+}
+
+static void Bench_Init( void )
+{
+}
+
+#else
+
+#define BENCH_UNIT          "cycles"
+
+extern void initialise_monitor_handles( void );
+
+static TIM_HandleTypeDef BenchTimer = {0};
+
+/**
+ * @brief   TIM6 counts the core clock, the benchmark does not run the scheduler that uses it at 1 us.
+ */
+static void Bench_Init( void )
+{
+    HAL_StatusTypeDef Status;
+
+    Status = HAL_Init();
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( Status == HAL_OK, HAL_RET_ERROR );
+
+    initialise_monitor_handles();
+
+    __HAL_RCC_TIM6_CLK_ENABLE();
+
+    /*Clock APB1 = 32 MHz, the timers run at APB1 x 2 = 64 MHz, the same as the core*/
+    BenchTimer.Instance = TIM6;
+    BenchTimer.Init.Prescaler = 0;                          /*One count per core cycle*/
+    BenchTimer.Init.CounterMode = TIM_COUNTERMODE_UP;
+    BenchTimer.Init.Period = 0xFFFF;
+    BenchTimer.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    BenchTimer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+    Status = HAL_TIM_Base_Init( &BenchTimer );
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( Status == HAL_OK, HAL_RET_ERROR );
+
+    Status = HAL_TIM_Base_Start( &BenchTimer );
+    /*cppcheck-suppress misra-c2012-11.8 ; Macro required for functional safety.*/
+    assert_error( Status == HAL_OK, HAL_RET_ERROR );
+}
+
+static uint32_t Bench_Now( void )
+{
+    return __HAL_TIM_GET_COUNTER( &BenchTimer );
+}
+
+/**
+ * @brief   The counter wraps every 65536 cycles, a batch has to take less.
+ */
+static uint32_t Bench_Elapsed( uint32_t start )
+{
+    return ( Bench_Now() - start ) & 0xFFFFu;
+}
+
+/**
+ * @brief   The HAL needs the SysTick, the interrupts of app_ints.c are not linked.
+ */
+void SysTick_Handler( void )
+{
+    HAL_IncTick();
+}
+
+#endif
+
+/**
+ * @brief   **Prints the time per call of every queue function and wrap method.**
+ */
+int main( void )
+{
+    uint32_t WriteTime;
+    uint32_t ReadTime;
+
+    Bench_Init();
+
+    BenchOverhead = Bench_Batch( BENCH_NONE, 0u );
+    for( uint32_t i = 0; i < BENCH_REPS; i++ )
+    {
+        uint32_t Time = Bench_Batch( BENCH_NONE, 0u );
+        BenchOverhead = ( Time < BenchOverhead ) ? Time : BenchOverhead;
+    }
+
+    ( void ) printf( "HIL_QUEUE benchmark, %s per call\n\n", BENCH_UNIT );
+    ( void ) printf( "%-10s %6s %9s %10s %10s\n", "functions", "size", "elements", "write", "read" );
+
+    for( uint32_t s = 0; s < ( sizeof( BenchSizes ) / sizeof( BenchSizes[ 0 ] ) ); s++ )
+    {
+        for( uint32_t e = 0; e < ( sizeof( BenchElements ) / sizeof( BenchElements[ 0 ] ) ); e++ )
+        {
+            uint8_t Size = BenchSizes[ s ];
+            uint32_t Elements = BenchElements[ e ];
+
+            WriteTime = Bench_Queue( BENCH_WRITE, BENCH_READ, Size, Elements, &ReadTime );
+            Bench_Row( "Write/Read", Size, Elements, WriteTime, ReadTime );
+
+            WriteTime = Bench_Queue( BENCH_WRITE_ISR, BENCH_READ_ISR, Size, Elements, &ReadTime );
+            Bench_Row( "ISR", Size, Elements, WriteTime, ReadTime );
+
+            if( ( Elements & ( Elements - 1u ) ) == 0u )
+            {
+                WriteTime = Bench_Queue( BENCH_WRITE_SPSC, BENCH_READ_SPSC, Size, Elements, &ReadTime );
+                Bench_Row( "SPSC", Size, Elements, WriteTime, ReadTime );
+            }
+        }
+    }
+
+    ( void ) printf( "\n%-10s %10s\n", "wrap", "increment" );
+    for( uint32_t op = ( uint32_t ) BENCH_WRAP_MOD; op <= ( uint32_t ) BENCH_WRAP_CMP; op++ )
+    {
+        ( void ) printf( "%-10s", BenchNames[ op ] );
+        Bench_Print( Bench_Wrap( ( BENCH_OpTypeDef ) op ) );
+        ( void ) printf( "\n" );
+    }
+
+#if defined( BENCH_HOST )
+    return 0;
+#else
+    for( ;; )
+    {
+    }
+#endif
+}
+
+/**
+ * @brief   Times n calls of a queue function or index increments of a wrap method.
+ * @param   op Function or wrap method
+ * @param   n Number of calls
+ * @retval  Time of the calls including the loop and the reading of the clock
+ */
+static uint32_t Bench_Batch( BENCH_OpTypeDef op, uint32_t n )
+{
+    uint32_t Elements = BenchWrapElements;
+    uint32_t Mask = Elements - 1u;
+    uint32_t Start = Bench_Now();
+
+    switch( op )
+    {
+        case BENCH_WRITE:
+            for( uint32_t i = 0; i < n; i++ ) { ( void ) HIL_QUEUE_Write( &BenchQueue, BenchData ); }
+        break;
+
+        case BENCH_READ:
+            for( uint32_t i = 0; i < n; i++ ) { ( void ) HIL_QUEUE_Read( &BenchQueue, BenchData ); }
+        break;
+
+        case BENCH_WRITE_ISR:
+            for( uint32_t i = 0; i < n; i++ ) { ( void ) HIL_QUEUE_WriteISR( &BenchQueue, BenchData, 0xFF ); }
+        break;
+
+        case BENCH_READ_ISR:
+            for( uint32_t i = 0; i < n; i++ ) { ( void ) HIL_QUEUE_ReadISR( &BenchQueue, BenchData, 0xFF ); }
+        break;
+
+        case BENCH_WRITE_SPSC:
+            for( uint32_t i = 0; i < n; i++ ) { ( void ) HIL_QUEUE_WriteSPSC( &BenchQueue, BenchData ); }
+        break;
+
+        case BENCH_READ_SPSC:
+            for( uint32_t i = 0; i < n; i++ ) { ( void ) HIL_QUEUE_ReadSPSC( &BenchQueue, BenchData ); }
+        break;
+
+        case BENCH_WRAP_MOD:
+            for( uint32_t i = 0; i < n; i++ ) { BenchIndex = ( BenchIndex + 1u ) % Elements; }
+        break;
+
+        case BENCH_WRAP_MASK:
+            for( uint32_t i = 0; i < n; i++ ) { BenchIndex = ( BenchIndex + 1u ) & Mask; }
+        break;
+
+        case BENCH_WRAP_CMP:
+            for( uint32_t i = 0; i < n; i++ ) { BenchIndex = ( BenchIndex == Mask ) ? 0u : ( BenchIndex + 1u ); }
+        break;
+
+        default:
+        break;
+    }
+
+    return Bench_Elapsed( Start );
+}
+
+/**
+ * @brief   Removes the time of reading the clock from the time of a batch.
+ * @param   time Time of the batch
+ * @retval  Time of the calls, 0 if the batch was faster than the overhead measured
+ */
+static uint32_t Bench_Net( uint32_t time )
+{
+    return ( time > BenchOverhead ) ? ( time - BenchOverhead ) : 0u;
+}
+
+/**
+ * @brief   Prints a time given in tenths of the unit.
+ * @param   time Time to print
+ */
+static void Bench_Print( uint32_t time )
+{
+    ( void ) printf( " %8lu.%lu", ( unsigned long ) ( time / 10u ), ( unsigned long ) ( time % 10u ) );
+}
+
+/**
+ * @brief   Prints the results of a pair of functions with a queue.
+ * @param   name Functions timed
+ * @param   size Size of the elements
+ * @param   elements Capacity of the queue
+ * @param   writeTime Time per call of the write function in tenths of the unit
+ * @param   readTime Time per call of the read function in tenths of the unit
+ */
+static void Bench_Row( const char *name, uint8_t size, uint32_t elements, uint32_t writeTime, uint32_t readTime )
+{
+    ( void ) printf( "%-10s %6u %9lu", name, ( unsigned ) size, ( unsigned long ) elements );
+    Bench_Print( writeTime );
+    Bench_Print( readTime );
+    ( void ) printf( "\n" );
+}
+
+/**
+ * @brief   Times the write and read functions filling and emptying a queue BENCH_REPS times.
+ * @param   write Function that fills the queue
+ * @param   read Function that empties the queue
+ * @param   size Size of the elements
+ * @param   elements Capacity of the queue
+ * @param   readTime Time per call of the read function
+ * @retval  Time per call of the write function, both in tenths of the unit
+ */
+static uint32_t Bench_Queue( BENCH_OpTypeDef write, BENCH_OpTypeDef read, uint8_t size, uint32_t elements, uint32_t *readTime )
+{
+    uint32_t WriteSum = 0;
+    uint32_t ReadSum = 0;
+
+    BenchQueue.Buffer = ( void * ) BenchBuffer;
+    BenchQueue.Elements = elements;
+    BenchQueue.Size = size;
+
+    for( uint32_t r = 0; r < BENCH_REPS; r++ )
+    {
+        if( write == BENCH_WRITE_SPSC )
+        {
+            HIL_QUEUE_InitSPSC( &BenchQueue );
+        }
+        else
+        {
+            HIL_QUEUE_Init( &BenchQueue );
+        }
+
+        for( uint32_t Done = 0; Done < elements; Done += BENCH_BATCH )
+        {
+            uint32_t n = ( ( elements - Done ) < BENCH_BATCH ) ? ( elements - Done ) : BENCH_BATCH;
+            WriteSum += Bench_Net( Bench_Batch( write, n ) );
+        }
+
+        for( uint32_t Done = 0; Done < elements; Done += BENCH_BATCH )
+        {
+            uint32_t n = ( ( elements - Done ) < BENCH_BATCH ) ? ( elements - Done ) : BENCH_BATCH;
+            ReadSum += Bench_Net( Bench_Batch( read, n ) );
+        }
+    }
+
+    *readTime = ( ReadSum * 10u ) / ( BENCH_REPS * elements );
+
+    return ( WriteSum * 10u ) / ( BENCH_REPS * elements );
+}
+
+/**
+ * @brief   Times BENCH_WRAP_N index increments of a wrap method over 16 elements.
+ * @param   op Wrap method
+ * @retval  Time per increment in tenths of the unit
+ */
+static uint32_t Bench_Wrap( BENCH_OpTypeDef op )
+{
+    uint32_t Sum = 0;
+
+    BenchIndex = 0;
+    for( uint32_t Done = 0; Done < BENCH_WRAP_N; Done += BENCH_BATCH )
+    {
+        Sum += Bench_Net( Bench_Batch( op, BENCH_BATCH ) );
+    }
+
+    return ( Sum * 10u ) / BENCH_WRAP_N;
+}
+
+/**
+ * @brief   The queues only go to the safe state with wrong parameters, the benchmark stops there.
+ */
+void Safe_State( uint8_t *file, uint32_t line, uint8_t error )
+{
+    ( void ) printf( "Safe state: %s:%lu error %u\n", ( char * ) file, ( unsigned long ) line, ( unsigned ) error );
+
+#if defined( BENCH_HOST )
+    exit( 1 );
+#else
+    for( ;; )
+    {
+    }
+#endif
+}
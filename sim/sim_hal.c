@@ -0,0 +1,109 @@
+/**
+ * @file    sim_hal.c
+ * @brief   **This file implements the HAL functions used by the scheduler over a virtual clock.**
+ *
+ * The SysTick runs at 1 ms and TIM6 at 1 us like in the board, both are read from the same
+ * virtual time so they never drift apart.
+ */
+
+#include "app_bsp.h"
+#include "sim_hal.h"
+
+/**
+ * @defgroup <CPU time in us spent by the functions that read the clock.>
+ @{ */
+#define SIM_GETTICK_TIME    1u  /*!< Keeps a busy loop without low power from freezing the time.*/
+/**
+ @} */
+
+TIM_TypeDef SIM_TIM6 = {0};
+
+static uint64_t Now = 0;
+static uint64_t End = 0;
+static uint64_t Sleep = 0;
+static jmp_buf *Exit = NULL;
+
+void SIM_Init( uint64_t endTime, jmp_buf *exit )
+{
+    Now = 0;
+    Sleep = 0;
+    End = endTime;
+    Exit = exit;
+}
+
+uint64_t SIM_Now( void )
+{
+    return Now;
+}
+
+void SIM_Run( uint32_t time )
+{
+    Now += time;
+}
+
+uint64_t SIM_SleepTime( void )
+{
+    return Sleep;
+}
+
+uint32_t HAL_GetTick( void )
+{
+    if( ( Now >= End ) && ( Exit != NULL ) )
+    {
+        longjmp( *Exit, 1 );
+    }
+    Now += SIM_GETTICK_TIME;
+
+    return ( uint32_t ) ( Now / 1000u );
+}
+
+uint32_t SIM_GetCounter( TIM_HandleTypeDef *htim )
+{
+    ( void ) htim;
+
+    return ( uint32_t ) ( Now & 0xFFFFu );
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init( TIM_HandleTypeDef *htim )
+{
+    ( void ) htim;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start( TIM_HandleTypeDef *htim )
+{
+    ( void ) htim;
+
+    return HAL_OK;
+}
+
+/*The only interrupt is the SysTick, the core wakes up on the next ms.*/
+void HAL_PWR_EnterSLEEPMode( uint32_t Regulator, uint8_t SLEEPEntry )
+{
+    uint64_t Wakeup = ( ( Now / 1000u ) + 1u ) * 1000u;
+
+    ( void ) Regulator;
+    ( void ) SLEEPEntry;
+
+    Sleep += Wakeup - Now;
+    Now = Wakeup;
+}
+
+void HAL_NVIC_EnableIRQ( IRQn_Type IRQn )
+{
+    ( void ) IRQn;
+}
+
+void HAL_NVIC_DisableIRQ( IRQn_Type IRQn )
+{
+    ( void ) IRQn;
+}
+
+void SIM_DisableIrq( void )
+{
+}
+
+void SIM_EnableIrq( void )
+{
+}
@@ -0,0 +1,36 @@
+/**
+ * @file    sim_hal.h
+ * @brief   **This file declares the virtual clock of the host simulator.**
+ *
+ * The time only moves when the simulated code spends it: a task runs, the scheduler reads the tick
+ * or the core sleeps until the next SysTick interrupt.
+ */
+
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+    #include <stdint.h>
+    #include <setjmp.h>
+
+    /**
+     * @brief   Starts the virtual clock from zero, once the end time is reached the next HAL_GetTick
+     * call jumps to exit.
+     */
+    void SIM_Init( uint64_t endTime, jmp_buf *exit );
+
+    /**
+     * @brief   Returns the virtual time in us.
+     */
+    uint64_t SIM_Now( void );
+
+    /**
+     * @brief   Moves the virtual time as CPU time spent by the simulated code.
+     */
+    void SIM_Run( uint32_t time );
+
+    /**
+     * @brief   Returns the virtual time in us the core spent sleeping.
+     */
+    uint64_t SIM_SleepTime( void );
+
+#endif
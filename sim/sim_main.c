@@ -0,0 +1,444 @@
+/**
+ * @file    sim_main.c
+ * @brief   **Host simulator of the scheduler over a virtual clock.**
+ *
+ * The scheduler is built for the host without changes and runs a set of simulated tasks, every task
+ * spends its execution time in the virtual clock instead of driving the hardware. The run ends after
+ * the simulated time and reports for every task the deadline misses, the lateness from the start of
+ * its period and the jitter of the period, the jitter histogram kept by the scheduler, and the time
+ * spent running tasks in every tick.
+ *
+ * Usage: scheduler_sim [-d ms] [-v %] [name=period,cost[,offset] ...]
+ *
+ * -d   Simulated time in ms, 60000 by default.
+ * -v   Random variation of the execution times in percent, 0 by default.
+ *
+ * Every task takes its period and offset in ms and its execution time in us, without tasks the five
+ * tasks of main.c are simulated with estimated execution times. Every period that ends while a task
+ * is still due or running is a deadline miss, the periods left at the end of the run included. The
+ * program returns 1 if a deadline is missed, a task that was due never ran or the scheduler went to
+ * the safe state.
+ */
+
+#include "app_bsp.h"
+#include "sim_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief   Structure with a simulated task and its results, times in us.
+ */
+typedef struct
+{
+    char        name[16];       /*!< Name to print in the report.*/
+    uint32_t    period;         /*!< Period in ms.*/
+    uint32_t    offset;         /*!< Offset in ms, 0 to let the scheduler choose.*/
+    uint32_t    cost;           /*!< Execution time.*/
+    uint32_t    runs;           /*!< Times the task was executed.*/
+    uint32_t    misses;         /*!< Periods that ended with the task still due or running.*/
+    uint64_t    due;            /*!< Start of the period of the next execution.*/
+    uint64_t    lastStart;      /*!< Start of the last execution.*/
+    uint32_t    latenessMax;    /*!< Longest time from the start of the period to the start of the execution.*/
+    uint64_t    latenessSum;    /*!< Sum of the lateness to calculate the mean.*/
+    uint32_t    jitterMax;      /*!< Largest difference between two starts and the period.*/
+    uint32_t    execMax;        /*!< Longest execution time.*/
+} SIM_TaskTypeDef;
+
+/**
+ * @brief   The tasks of main.c, the execution times are estimations to be replaced by the profiler
+ * readings of the board.
+ */
+static const SIM_TaskTypeDef DefaultTasks[] =
+{
+    { "heart_beat",  300u,  0u,   20u },
+    { "serial",       10u,  0u,   60u },
+    { "clock",        50u,  0u,  250u },
+    { "display",     100u,  0u, 1800u },
+    { "pet_the_dog",  80u,  0u,   15u }
+};
+
+Scheduler_HandleTypeDef Sche;
+uint8_t SerialTaskID = 0;
+
+static SIM_TaskTypeDef Tasks[TASKS_N];
+static uint32_t TasksCount = 0;
+static uint32_t Variation = 0;
+static uint32_t Random = 12345u;
+static uint32_t *TickBusy = NULL;
+static uint32_t TickCount = 0;
+static jmp_buf Exit;
+static uint8_t SafeError = 0;
+static char *SafeFile = NULL;
+static uint32_t SafeLine = 0;
+static uint8_t Running = 0;
+
+static void SIM_Execute( uint32_t task );
+static void SIM_AddBusy( uint64_t start, uint64_t end );
+static void SIM_Report( uint64_t time );
+static uint64_t SIM_FirstDue( uint32_t task );
+static uint32_t SIM_Pending( uint64_t time );
+static void SIM_Init_Task( void );
+
+/**
+ * @brief   One function per simulated task, the scheduler only knows the tasks by their function.
+ @{ */
+#define SIM_TASK( n )   static void SIM_Task##n( void ) { SIM_Execute( n ); }
+SIM_TASK( 0 )  SIM_TASK( 1 )  SIM_TASK( 2 )  SIM_TASK( 3 )  SIM_TASK( 4 )  SIM_TASK( 5 )  SIM_TASK( 6 )  SIM_TASK( 7 )
+SIM_TASK( 8 )  SIM_TASK( 9 )  SIM_TASK( 10 ) SIM_TASK( 11 ) SIM_TASK( 12 ) SIM_TASK( 13 ) SIM_TASK( 14 ) SIM_TASK( 15 )
+
+static void ( * const TaskFunctions[] )( void ) =
+{
+    SIM_Task0, SIM_Task1, SIM_Task2,  SIM_Task3,  SIM_Task4,  SIM_Task5,  SIM_Task6,  SIM_Task7,
+    SIM_Task8, SIM_Task9, SIM_Task10, SIM_Task11, SIM_Task12, SIM_Task13, SIM_Task14, SIM_Task15
+};
+/**
+ @} */
+
+int main( int argc, char *argv[] )
+{
+    static Task_TypeDef tcbs[ TASKS_N ];
+    static Timer_TypeDef timers[ TIMERS_N ];
+    uint32_t Duration = 60000u;
+    uint64_t Time;
+    uint32_t Failed;
+    int Arg;
+
+    for( Arg = 1; Arg < argc; Arg++ )
+    {
+        if( ( argv[Arg][0] == '-' ) && ( ( Arg + 1 ) < argc ) )
+        {
+            if( argv[Arg][1] == 'd' )
+            {
+                Duration = ( uint32_t ) strtoul( argv[Arg + 1], NULL, 10 );
+            }
+            else if( argv[Arg][1] == 'v' )
+            {
+                Variation = ( uint32_t ) strtoul( argv[Arg + 1], NULL, 10 );
+            }
+            else
+            {
+                fprintf( stderr, "unknown option %s\n", argv[Arg] );
+                return 2;
+            }
+            Arg++;
+        }
+        else if( TasksCount < ( sizeof( TaskFunctions ) / sizeof( TaskFunctions[0] ) ) && ( TasksCount < TASKS_N ) )
+        {
+            SIM_TaskTypeDef *Task = &Tasks[TasksCount];
+
+            ( void ) memset( Task, 0, sizeof( SIM_TaskTypeDef ) );
+            if( sscanf( argv[Arg], "%15[^=]=%u,%u,%u", Task->name, &Task->period, &Task->cost, &Task->offset ) < 3 )
+            {
+                fprintf( stderr, "task %s is not name=period,cost[,offset]\n", argv[Arg] );
+                return 2;
+            }
+            TasksCount++;
+        }
+        else
+        {
+            fprintf( stderr, "too many tasks, the simulator is built for %u\n", ( unsigned ) TASKS_N );
+            return 2;
+        }
+    }
+
+    if( TasksCount == 0u )
+    {
+        TasksCount = sizeof( DefaultTasks ) / sizeof( DefaultTasks[0] );
+        ( void ) memcpy( Tasks, DefaultTasks, sizeof( DefaultTasks ) );
+    }
+
+    TickCount = ( Duration / TICK_VAL ) + 1u;
+    TickBusy = calloc( TickCount, sizeof( uint32_t ) );
+    if( TickBusy == NULL )
+    {
+        return 2;
+    }
+
+    Sche.tick = TICK_VAL;
+    Sche.tasks = TASKS_N;
+    Sche.taskPtr = tcbs;
+    Sche.timers = TIMERS_N;
+    Sche.timerPtr = timers;
+    HIL_SCHEDULER_Init( &Sche );
+
+    for( uint32_t i = 0; i < TasksCount; i++ )
+    {
+        if( HIL_SCHEDULER_RegisterTask( &Sche, SIM_Init_Task, TaskFunctions[i], Tasks[i].period ) == 0u )
+        {
+            fprintf( stderr, "task %s: the period must be a multiple of %u ms\n", Tasks[i].name, ( unsigned ) TICK_VAL );
+            return 2;
+        }
+        if( ( Tasks[i].offset != 0u ) && ( HIL_SCHEDULER_OffsetTask( &Sche, i + 1u, Tasks[i].offset ) == 0u ) )
+        {
+            fprintf( stderr, "task %s: the offset must be a multiple of %u ms shorter than the period\n", Tasks[i].name, ( unsigned ) TICK_VAL );
+            return 2;
+        }
+    }
+
+    SIM_Init( ( uint64_t ) Duration * 1000u, &Exit );
+    if( setjmp( Exit ) == 0 )
+    {
+        Running = 1;
+        HIL_SCHEDULER_Start( &Sche );
+    }
+    Running = 0;
+
+    Time = SIM_Now();
+    Failed = SIM_Pending( Time );
+    SIM_Report( Time );
+    free( TickBusy );
+
+    for( uint32_t i = 0; i < TasksCount; i++ )
+    {
+        if( Tasks[i].misses != 0u )
+        {
+            Failed++;
+        }
+    }
+    if( Failed != 0u )
+    {
+        SafeError = ( SafeError == 0u ) ? 0xFFu : SafeError;
+    }
+
+    return ( SafeError != 0u ) ? 1 : 0;
+}
+
+/**
+ * @brief   Init function of the simulated tasks, it takes no time.
+ */
+static void SIM_Init_Task( void )
+{
+}
+
+/**
+ * @brief   Runs a simulated task, spending its execution time and measuring it against the tick
+ * where the task was due.
+ */
+static void SIM_Execute( uint32_t task )
+{
+    SIM_TaskTypeDef *Task = &Tasks[task];
+    uint64_t Start = SIM_Now();
+    uint64_t Period = ( uint64_t ) Task->period * 1000u;
+    uint32_t Cost = Task->cost;
+    uint32_t Lateness;
+    uint32_t Jitter;
+    uint32_t Missed;
+
+    if( Variation != 0u )
+    {
+        Random = ( Random * 1103515245u ) + 12345u;
+        Cost = ( uint32_t ) ( ( ( uint64_t ) Cost * ( 100u - Variation + ( ( Random >> 16 ) % ( ( 2u * Variation ) + 1u ) ) ) ) / 100u );
+    }
+
+    if( Task->runs == 0u )
+    {
+        Task->due = SIM_FirstDue( task );
+    }
+    else
+    {
+        Jitter = ( uint32_t ) ( ( ( Start - Task->lastStart ) > Period ) ? ( ( Start - Task->lastStart ) - Period ) : ( Period - ( Start - Task->lastStart ) ) );
+        if( Jitter > Task->jitterMax )
+        {
+            Task->jitterMax = Jitter;
+        }
+    }
+
+    Lateness = ( Start > Task->due ) ? ( uint32_t ) ( Start - Task->due ) : 0u;
+    if( Lateness > Task->latenessMax )
+    {
+        Task->latenessMax = Lateness;
+    }
+    Task->latenessSum += Lateness;
+
+    SIM_Run( Cost );
+    SIM_AddBusy( Start, SIM_Now() );
+
+    /*Every period that ended before the execution finished is a miss.*/
+    Missed = ( SIM_Now() > Task->due ) ? ( uint32_t ) ( ( SIM_Now() - Task->due - 1u ) / Period ) : 0u;
+    Task->misses += Missed;
+    if( Cost > Task->execMax )
+    {
+        Task->execMax = Cost;
+    }
+
+    /*The periods are kept from the first one, a task the scheduler runs late stays late until it
+    loses a whole period.*/
+    Task->due += ( ( uint64_t ) Missed + 1u ) * Period;
+    Task->lastStart = Start;
+    Task->runs++;
+}
+
+/**
+ * @brief   Time when the first execution of a task is due, one offset after the start or one period
+ * without offset.
+ */
+static uint64_t SIM_FirstDue( uint32_t task )
+{
+    uint32_t Offset = Sche.taskPtr[task].offset;
+
+    return ( uint64_t ) ( ( Offset != 0u ) ? Offset : Tasks[task].period ) * 1000u;
+}
+
+/**
+ * @brief   Counts the misses of the tasks still due at the end of the run, every period that ended
+ * since the task was due is a miss.
+ * @retval  The number of tasks that were due and never ran.
+ */
+static uint32_t SIM_Pending( uint64_t time )
+{
+    uint32_t Starved = 0;
+
+    for( uint32_t i = 0; i < TasksCount; i++ )
+    {
+        SIM_TaskTypeDef *Task = &Tasks[i];
+        uint64_t Due = ( Task->runs == 0u ) ? SIM_FirstDue( i ) : Task->due;
+
+        if( time >= Due )
+        {
+            Task->misses += ( uint32_t ) ( ( time - Due ) / ( ( uint64_t ) Task->period * 1000u ) );
+            if( Task->runs == 0u )
+            {
+                Starved++;
+            }
+        }
+    }
+
+    return Starved;
+}
+
+/**
+ * @brief   Adds the time between start and end to the busy time of the ticks it spans.
+ */
+static void SIM_AddBusy( uint64_t start, uint64_t end )
+{
+    uint64_t TickTime = ( uint64_t ) TICK_VAL * 1000u;
+    uint64_t From = start;
+    uint64_t To;
+    uint64_t Tick;
+
+    while( From < end )
+    {
+        Tick = From / TickTime;
+        To = ( ( Tick + 1u ) * TickTime < end ) ? ( ( Tick + 1u ) * TickTime ) : end;
+        if( Tick < TickCount )
+        {
+            TickBusy[Tick] += ( uint32_t ) ( To - From );
+        }
+        From = To;
+    }
+}
+
+/**
+ * @brief   Prints the results of the simulation.
+ */
+static void SIM_Report( uint64_t time )
+{
+    uint64_t TickTime = ( uint64_t ) TICK_VAL * 1000u;
+    uint32_t Ticks = ( uint32_t ) ( time / TickTime );
+    uint32_t Histogram[11] = {0};
+    uint32_t Worst = 0;
+    uint64_t Busy = 0;
+    SchedulerLoad_TypeDef Load;
+    TaskStats_TypeDef Stats;
+    TaskJitter_TypeDef Jitter;
+
+    printf( "simulated %llu ms, tick %u ms, low power %u, tick budget %u us, auto phase %u\n",
+            ( unsigned long long ) ( time / 1000u ), ( unsigned ) TICK_VAL, ( unsigned ) SCHEDULER_LOW_POWER,
+            ( unsigned ) SCHEDULER_TICK_BUDGET, ( unsigned ) SCHEDULER_AUTO_PHASE );
+    if( SafeError != 0u )
+    {
+        printf( "SAFE STATE: error %u at %s:%u\n", ( unsigned ) SafeError, SafeFile, ( unsigned ) SafeLine );
+    }
+
+    printf( "\n%-16s %7s %7s %7s %8s %7s %8s %8s %8s %8s\n", "task", "period", "offset", "cost", "runs", "misses",
+            "late_avg", "late_max", "jit_max", "exec_max" );
+    for( uint32_t i = 0; i < TasksCount; i++ )
+    {
+        SIM_TaskTypeDef *Task = &Tasks[i];
+
+        printf( "%-16s %7u %7u %7u %8u %7u %8u %8u %8u %8u\n", Task->name, ( unsigned ) Task->period,
+                ( unsigned ) Sche.taskPtr[i].offset, ( unsigned ) Task->cost, ( unsigned ) Task->runs,
+                ( unsigned ) Task->misses,
+                ( unsigned ) ( ( Task->runs != 0u ) ? ( Task->latenessSum / Task->runs ) : 0u ),
+                ( unsigned ) Task->latenessMax, ( unsigned ) Task->jitterMax, ( unsigned ) Task->execMax );
+    }
+    for( uint32_t i = 0; i < TasksCount; i++ )
+    {
+        if( ( Tasks[i].runs == 0u ) && ( time >= SIM_FirstDue( i ) ) )
+        {
+            printf( "task %s was due at %llu ms and never ran\n", Tasks[i].name, ( unsigned long long ) ( SIM_FirstDue( i ) / 1000u ) );
+        }
+    }
+
+    for( uint32_t i = 0; ( i < Ticks ) && ( i < TickCount ); i++ )
+    {
+        uint32_t Percent = ( uint32_t ) ( ( ( uint64_t ) TickBusy[i] * 100u ) / TickTime );
+
+        Histogram[( Percent > 100u ) ? 10u : ( Percent / 10u )]++;
+        Worst = ( TickBusy[i] > Worst ) ? TickBusy[i] : Worst;
+        Busy += TickBusy[i];
+    }
+
+    printf( "\ntask time per tick: worst %u us (%u%%), mean %u us\n", ( unsigned ) Worst,
+            ( unsigned ) ( ( ( uint64_t ) Worst * 100u ) / TickTime ), ( unsigned ) ( ( Ticks != 0u ) ? ( Busy / Ticks ) : 0u ) );
+    for( uint32_t i = 0; i < 10u; i++ )
+    {
+        if( Histogram[i] != 0u )
+        {
+            printf( "  %3u-%3u%% %8u ticks\n", ( unsigned ) ( i * 10u ), ( unsigned ) ( ( i * 10u ) + 10u ), ( unsigned ) Histogram[i] );
+        }
+    }
+    if( Histogram[10] != 0u )
+    {
+        printf( "     >100%% %8u ticks\n", ( unsigned ) Histogram[10] );
+    }
+    printf( "core asleep %llu ms\n", ( unsigned long long ) ( SIM_SleepTime() / 1000u ) );
+
+    if( HIL_SCHEDULER_GetLoad( &Sche, &Load ) != 0u )
+    {
+        printf( "load meter: 1 s %u.%u%%, 10 s %u.%u%%, 60 s %u.%u%%, peak tick %u.%u%%\n",
+                ( unsigned ) ( Load.load1s / 10u ), ( unsigned ) ( Load.load1s % 10u ),
+                ( unsigned ) ( Load.load10s / 10u ), ( unsigned ) ( Load.load10s % 10u ),
+                ( unsigned ) ( Load.load60s / 10u ), ( unsigned ) ( Load.load60s % 10u ),
+                ( unsigned ) ( Load.peakTick / 10u ), ( unsigned ) ( Load.peakTick % 10u ) );
+    }
+
+    printf( "\n%-16s %7s %7s  deviation from the period in ms: 0, 1, 2-3, 4-7, ...\n", "jitter", "misses", "max" );
+    for( uint32_t i = 0; i < TasksCount; i++ )
+    {
+        ( void ) HIL_SCHEDULER_GetJitter( &Sche, i + 1u, &Jitter );
+        printf( "%-16s %7u %7u ", Tasks[i].name, ( unsigned ) Jitter.misses, ( unsigned ) Jitter.maxDeviation );
+        for( uint32_t j = 0; j < ( uint32_t ) SCHEDULER_JITTER_BINS; j++ )
+        {
+            printf( " %7u", ( unsigned ) Jitter.bins[j] );
+        }
+        printf( "\n" );
+    }
+
+    if( HIL_SCHEDULER_GetTaskStats( &Sche, 1, &Stats ) != 0u )
+    {
+        printf( "\n%-16s %8s %8s %8s %8s\n", "profiler", "min", "mean", "max", "overruns" );
+        for( uint32_t i = 0; i < TasksCount; i++ )
+        {
+            ( void ) HIL_SCHEDULER_GetTaskStats( &Sche, i + 1u, &Stats );
+            printf( "%-16s %8u %8u %8u %8u\n", Tasks[i].name, ( unsigned ) ( ( Stats.runs != 0u ) ? Stats.minTime : 0u ),
+                    ( unsigned ) Stats.meanTime, ( unsigned ) Stats.maxTime, ( unsigned ) Stats.overruns );
+        }
+    }
+}
+
+/**
+ * @brief   Safe state of the simulator, the simulation stops and the error is reported.
+ */
+void Safe_State( uint8_t *file, uint32_t line, uint8_t error )
+{
+    SafeError = error;
+    SafeFile = ( char * ) file;
+    SafeLine = line;
+    if( Running == 0u )
+    {
+        fprintf( stderr, "SAFE STATE: error %u at %s:%u\n", ( unsigned ) error, SafeFile, ( unsigned ) line );
+        exit( 2 );
+    }
+    longjmp( Exit, 1 );
+}
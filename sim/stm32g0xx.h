@@ -0,0 +1,107 @@
+/**
+ * @file    stm32g0xx.h
+ * @brief   **Stub of the CMSIS device header and the HAL for the host simulator.**
+ *
+ * Only the types, macros and functions used by the scheduler and the queues are declared, the
+ * functions are implemented in sim_hal.c over a virtual clock. The rest of the HAL headers included
+ * by app_bsp.h are empty files that include this one.
+ */
+
+#ifndef STM32G0XX_H
+#define STM32G0XX_H
+
+    #include <stdint.h>
+    #include <stddef.h>
+
+    /**
+     * @brief HAL status values.
+    */
+    typedef enum
+    {
+        HAL_OK       = 0x00U,
+        HAL_ERROR    = 0x01U,
+        HAL_BUSY     = 0x02U,
+        HAL_TIMEOUT  = 0x03U
+    } HAL_StatusTypeDef;
+
+    /**
+     * @brief Interrupt numbers, the values don't matter on the host.
+    */
+    typedef enum
+    {
+        WWDG_IRQn               = 0,
+        TIM6_DAC_LPTIM1_IRQn    = 17,
+        TIM16_FDCAN_IT0_IRQn    = 21
+    } IRQn_Type;
+
+    /**
+     * @brief Timer registers, the simulated counter is the virtual clock in us.
+    */
+    typedef struct
+    {
+        uint32_t CNT;
+    } TIM_TypeDef;
+
+    /**
+     * @brief Timer base configuration.
+    */
+    typedef struct
+    {
+        uint32_t Prescaler;
+        uint32_t CounterMode;
+        uint32_t Period;
+        uint32_t ClockDivision;
+        uint32_t RepetitionCounter;
+        uint32_t AutoReloadPreload;
+    } TIM_Base_InitTypeDef;
+
+    /**
+     * @brief Timer handle.
+    */
+    typedef struct
+    {
+        TIM_TypeDef             *Instance;
+        TIM_Base_InitTypeDef    Init;
+    } TIM_HandleTypeDef;
+
+    /**
+     * @brief Handles of the peripherals declared by app_bsp.h, not used by the simulator.
+    */
+    typedef struct
+    {
+        void *Instance;
+    } WWDG_HandleTypeDef;
+
+    typedef struct
+    {
+        void *Instance;
+    } FDCAN_HandleTypeDef;
+
+    extern TIM_TypeDef SIM_TIM6;
+
+    #define TIM6                                ( &SIM_TIM6 )
+    #define TIM_COUNTERMODE_UP                  0x00000000U
+    #define TIM_CLOCKDIVISION_DIV1              0x00000000U
+    #define TIM_AUTORELOAD_PRELOAD_DISABLE      0x00000000U
+    #define PWR_MAINREGULATOR_ON                0x00000000U
+    #define PWR_SLEEPENTRY_WFI                  ( ( uint8_t ) 0x01U )
+
+    #define __weak                              __attribute__( ( weak ) )
+    #define __HAL_RCC_TIM6_CLK_ENABLE()         do { } while( 0 )
+    #define __HAL_TIM_GET_COUNTER( htim )       SIM_GetCounter( htim )
+    #define __disable_irq()                     SIM_DisableIrq()
+    #define __enable_irq()                      SIM_EnableIrq()
+    #define __DMB()                             __sync_synchronize()
+
+    uint32_t HAL_GetTick( void );
+    HAL_StatusTypeDef HAL_TIM_Base_Init( TIM_HandleTypeDef *htim );
+    HAL_StatusTypeDef HAL_TIM_Base_Start( TIM_HandleTypeDef *htim );
+    void HAL_PWR_EnterSLEEPMode( uint32_t Regulator, uint8_t SLEEPEntry );
+    void HAL_NVIC_EnableIRQ( IRQn_Type IRQn );
+    void HAL_NVIC_DisableIRQ( IRQn_Type IRQn );
+
+    uint32_t SIM_GetCounter( TIM_HandleTypeDef *htim );
+    void SIM_DisableIrq( void );
+    void SIM_EnableIrq( void );
+
+#endif
@@ -0,0 +1,11 @@
+/**
+ * @file    stm32g0xx_hal_gpio.h
+ * @brief   **Empty HAL header for the host simulator, everything is declared in stm32g0xx.h.**
+ */
+
+#ifndef STM32G0XX_HAL_GPIO_H
+#define STM32G0XX_HAL_GPIO_H
+
+    #include "stm32g0xx.h"
+
+#endif